@@ -4,6 +4,9 @@
 #include "core/DataStruct.hpp"
 #include "core/PathFinder.hpp"
 
+// 覆盖层的 [y, x] 视图（动画状态码，0=无）
+using OverlayView = std::mdspan<uint8_t, std::dextents<size_t, 2>>;
+
 // UI 枚举，表示当前聚焦的输入框类型
 enum class UI
 {
@@ -15,7 +18,9 @@ enum class UI
     EndX,           // 终点 X 输入框
     EndY,           // 终点 Y 输入框
     UpdateEvery,    // 更新频率输入框
-    DelayMs         // 动画延迟输入框
+    DelayMs,        // 动画延迟输入框
+    MazeW,          // 迷宫宽度输入框
+    MazeH           // 迷宫高度输入框
 };
 
 // Viewer 类，负责迷宫的渲染、交互和主逻辑
@@ -23,8 +28,8 @@ class Viewer {
 public:
     // 获取 Viewer 单例对象
     static Viewer& getInstance();
-    // 主循环，初始化窗口和 OpenGL，渲染迷宫和 UI
-    void run();
+    // 主循环，初始化窗口和 OpenGL，渲染迷宫和 UI；mazePath 非空时打开该迷宫文件而不是重新生成
+    void run(const std::string& mazePath = {});
     // 处理窗口尺寸变化，更新帧缓冲区宽高
     void onFramebufferResized(int width, int height);
 
@@ -57,10 +62,18 @@ private:
     void rebuildMeshFromMaze(const Maze& m);
     // 如果迷宫数据有变则重建渲染网格
     void rebuildMesh();
+    // 覆盖层视图（按迷宫尺寸）
+    OverlayView overlayGrid();
+    // 清空覆盖层，开始新一轮动画
+    void clearOverlay();
 
     // -------- 迷宫和路径相关 --------
     // 生成迷宫，并同步 UI 起终点
     void buildMaze(int32_t seed);
+    // 打开迷宫文件（mmap），并同步 UI 起终点
+    void loadMaze(const std::string& path);
+    // 替换当前迷宫，重置覆盖层和动画
+    void setMaze(Maze&& m);
     // 寻找路径或计数路径，根据算法类型更新动画和迷宫状态
     void findPath(int32_t sx, int32_t sy, int32_t ex, int32_t ey, int32_t algoIndex);
     // 更新路径动画（根据动画模式刷新迷宫显示）
@@ -82,9 +95,6 @@ private:
         int visitedVal = 15;        // 已访问点的颜色值
         int pathVal    = 5;         // 路径点的颜色值
 
-        bool hasOrigWall = false;   // 是否保存了原始墙体
-        std::vector<uint8_t> origWall; // 原始墙体数据
-
         size_t lastVisitedN = (size_t)-1; // 上一次已访问点数量
         size_t lastPathN    = (size_t)-1; // 上一次路径点数量
 
@@ -117,7 +127,8 @@ private:
     int meshBuiltFbH = 0;                     // 网格构建时的高度
 
     // -------- 迷宫状态（与渲染器共享） --------
-    Maze maze{};                              // 当前迷宫
+    Maze maze{};                              // 当前迷宫（墙体层，算法只读）
+    std::vector<uint8_t> overlay;             // 覆盖层（路径动画状态码，渲染器读取）
     bool mazeLoaded = false;                  // 是否已加载迷宫
     bool mazeDirty = false;                   // 迷宫数据是否有变
 
@@ -134,6 +145,15 @@ private:
     int uiUpdateEvery = 4;                    // 更新频率
     int uiDelayMs = 0;                        // 动画延迟
     int uiAlgoIndex = 0;                      // 当前算法类型
+    int uiMazeW = 41, uiMazeH = 41;           // 生成尺寸（BUILD 时规整为奇数）
+    MazeGenerator uiGenerator = MazeGenerator::Backtracker;   // 生成算法（G 键切换）
+
+    // 网格按块画，每边最多 MeshMaxBlocks 块：顶点最坏约 38 MB，与迷宫尺寸无关
+    static constexpr int MeshMaxBlocks = 512;
+    // 面板和 --open 接受的最大边长。重建网格仍要扫一遍所有格子，动画期间每帧都重建；
+    // 实测（带访问覆盖）1001x1001 每次约 70 ms、顶点 27 MB，4001x4001 每次约 110 ms、顶点 0.1 MB。
+    // 更大的迷宫用 --save / --stream 生成，不进 Viewer
+    static constexpr int ViewerMaxSide = 4001;
 
     // “路径信息”框中显示的结果
     int lastPathLen  = 0;   // 路径长度（A*）
@@ -141,5 +161,9 @@ private:
     int lastCountWays = 0;  // 路径总数（计数模式）
     int lastPassLen  = 0;   // 强制经过点的路径长度
 
-    std::vector<uint8_t> baseWall;            // 基础墙体数据（1=墙，0=空）
+    // 算法输出的复用缓冲（与动画数据交换，避免每次查询重新分配）
+    SearchResult searchBuf;
+    CountResult  countBuf;
+    PassResult   passBuf;
+    SearchContext searchCtx{ .openList = OpenListPolicy::Buckets };   // A* 工作区，跨查询复用
 };
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+#include "core/Common.hpp"
+
+// 单调桶队列（Dial）：键是小的非负整数，且每次 Push 的键不小于最近一次 Pop 出的键
+// （一致启发的 A* / 整数边权的 Dijkstra 都满足）。环形桶数组按键取模定位，跨度不够时翻倍；
+// Push / Pop 均摊 O(1)，同键后进先出。Clear 保留每个桶的容量，预热后反复使用不再分配
+template<class T>
+class BucketQueue
+{
+public:
+    bool Empty() const { return count == 0; }
+    size_t Size() const { return count; }
+
+    // 队列里最小的键（非空时有效）
+    uint32_t MinKey() {
+        Settle();
+        return base;
+    }
+
+    void Clear() {
+        for (auto& b : buckets) b.clear();
+        count = 0;
+        base = 0;
+        top = 0;
+    }
+
+    void Push(uint32_t key, const T& value) {
+        if (count == 0)
+        {
+            base = key;
+            top = key;
+        }
+        else if (key < base)
+        {
+            // 比当前下界小（仍不小于上次弹出的键）：下界前移，环不够长先扩
+            const size_t span = (size_t)(top - key) + 1;
+            if (span > buckets.size()) Grow(span);
+            base = key;
+        }
+        top = std::max(top, key);
+        const size_t span = (size_t)(top - base) + 1;
+        if (span > buckets.size()) Grow(span);
+        buckets[key & mask].push_back(value);
+        ++count;
+    }
+
+    T Pop() {
+        Settle();
+        auto& b = buckets[base & mask];
+        T v = b.back();
+        b.pop_back();
+        --count;
+        return v;
+    }
+
+private:
+    // 把 base 推进到第一个非空桶；弹出的键单调不减，所以一轮查询里扫描总量受键的范围限制
+    void Settle() {
+        while (buckets[base & mask].empty()) ++base;
+    }
+
+    // 环扩到不小于 span 的 2 的幂；活着的键都在 [base, top] 里，逐桶搬到新位置（移动保留容量）
+    void Grow(size_t span) {
+        const size_t n = std::bit_ceil(std::max<size_t>(span, 8));
+        std::vector<std::vector<T>> next(n);
+        for (uint32_t key = base; count && key <= top; ++key)
+            next[key & (n - 1)] = std::move(buckets[key & mask]);
+        buckets = std::move(next);
+        mask = (uint32_t)(n - 1);
+    }
+
+    std::vector<std::vector<T>> buckets{};
+    uint32_t mask = 0;
+    uint32_t base = 0;      // 当前最小键的下界
+    uint32_t top = 0;       // 当前最大键的上界
+    size_t count = 0;
+};
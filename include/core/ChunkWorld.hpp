@@ -0,0 +1,83 @@
+#pragma once
+#include "core/Common.hpp"
+#include "core/DataStruct.hpp"
+
+#include <list>
+
+// 无限分块迷宫世界：世界格子坐标 (x, y) 为 int64（可为负），房间在奇数坐标上；块号是 int32，
+// 所以可用范围是每个方向 ±2^31 块（块边长 128 时约 ±2.7e11 格），超出的坐标抛 std::out_of_range，不回绕。
+// 每块 side x side 格（side = 2 * chunkRooms），块 (cx, cy) 覆盖 [cx*side, (cx+1)*side) x [cy*side, (cy+1)*side)，
+// 用到时才由 MazeBuilder::BuildChunk 按 (seed, cx, cy) 生成；接缝由拥有它的块单方面决定，相邻块不必同时在内存里。
+// 块内是完美迷宫、块间四边各一个口，整个世界连通（块的尺度上有环）
+struct ChunkWorldOptions
+{
+    int32_t chunkRooms = 64;                          // 块边长 2 * chunkRooms 格
+    MazeGenerator generator = MazeGenerator::Backtracker;
+    size_t memoryCap = 64ull << 20;                   // 缓存块的总字节上限，超出时淘汰最久未用的块（至少留一块）
+};
+
+// 块缓存按最近使用淘汰；开销只和实际访问到的区域成正比。非线程安全
+class ChunkWorld
+{
+public:
+    explicit ChunkWorld(int seed, const ChunkWorldOptions& options = {});
+
+    int32_t ChunkSide() const { return side; }
+
+    // 世界坐标所在的块号（向下取整）；可能超出 int32，用 Contains 判断
+    int64_t ChunkOf(int64_t v) const {
+        return v / side - (v % side < 0);
+    }
+
+    // 格子所在的块号在 int32 范围内
+    bool Contains(int64_t x, int64_t y) const {
+        return InChunkRange(ChunkOf(x)) && InChunkRange(ChunkOf(y));
+    }
+
+    // 块 (cx, cy) 的位图，不在缓存里就生成；只有前 side x side 格有效（见 MazeBuilder::BuildChunk）
+    // 引用只保证到下一次访问别的块（可能被淘汰）
+    const WallBitmap& Chunk(int32_t cx, int32_t cy);
+
+    // 按格子读；连续落在同一块上时不查表。坐标超出范围抛 std::out_of_range
+    bool IsWall(int64_t x, int64_t y);
+
+    // 把 [x0, x0+w) x [y0, y0+h) 拷成普通 Maze（世界 (x0, y0) 对应 (0, 0)），交给现有求解器和 Viewer
+    // 逐块整字拷贝，每块只取一次；区域边缘切断的通道视为墙外。区域有一角超出范围抛 std::out_of_range
+    Maze Region(int64_t x0, int64_t y0, int32_t w, int32_t h);
+
+    size_t CachedChunks() const { return table.size(); }
+    size_t CachedBytes() const { return bytes; }
+    uint64_t Generated() const { return generated; }   // 累计生成（含淘汰后重新生成）的块数
+
+    void Clear();
+
+private:
+    struct Entry
+    {
+        uint64_t key;
+        WallBitmap walls;
+    };
+
+    static bool InChunkRange(int64_t c) {
+        return c >= INT32_MIN && c <= INT32_MAX;
+    }
+    static uint64_t Key(int32_t cx, int32_t cy) {
+        return ((uint64_t)(uint32_t)cx << 32) | (uint64_t)(uint32_t)cy;
+    }
+    size_t EntryBytes(const Entry& e) const {
+        return sizeof(Entry) + e.walls.WordCount() * sizeof(uint64_t);
+    }
+
+    int seed;
+    ChunkWorldOptions options;
+    int32_t side;
+
+    std::list<Entry> lru;                                             // 最近用过的在前
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> table;
+    size_t bytes = 0;
+    uint64_t generated = 0;
+
+    // IsWall 的快路径：上一次访问的块
+    uint64_t lastKey = 0;
+    const WallBitmap* last = nullptr;
+};
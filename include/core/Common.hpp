@@ -24,4 +24,7 @@
 #include <string>
 #include <algorithm> 
 #include <tuple>
-#include <set>
\ No newline at end of file
+#include <set>
+#include <bit>
+#include <array>
+#include <span>
\ No newline at end of file
@@ -12,18 +12,460 @@ struct Point
     }
 };
 
+// 墙体位图的内存布局
+enum class MazeLayout : uint8_t
+{
+    RowMajor,   // bit[y * width + x]
+    Tiled8x8,   // 每个 8x8 块占一个 64 位字（块内 bit = (y%8)*8 + x%8），块按行主序排列
+};
+
+// 生成算法（写入迷宫文件头，值不可改动）
+enum class MazeGenerator : uint8_t
+{
+    Backtracker,    // 随机 DFS 回溯：长走廊，父方向暂存在网格里，无额外内存
+    Kruskal,        // 随机边序 + 并查集：每房间约 21 字节临时内存
+    Prim,           // 随机前沿边：短死路多，前沿表随面积增长
+    Wilson,         // 擦圈随机游走：均匀生成树，最慢，每房间 1 字节
+    HuntAndKill,    // 随机游走 + 逐行搜寻：无额外内存，搜寻代价随面积增长
+    BinaryTree,     // 每房间独立选北/西：最快，对角偏向
+    Sidewinder,     // 按行成段向北打通：一次一行，只需 O(1) 状态
+    Eller,          // 逐行维护集合：只需 O(宽度) 状态，可流式输出任意高度
+    BinaryTreeSimd, // 同 BinaryTree 规则，64 个房间一组按位生成整行字（AVX2 / 标量），批量造数据用
+    SidewinderSimd, // 同 Sidewinder 规则，成段与向东按位生成，每段的北口逐段抽取
+};
+
+// 1 bit/格 的墙体位图（1=墙）；布局不影响对外的 (x, y) / 线性下标接口
+struct WallBitmap
+{
+    std::vector<uint64_t> words{};            // 自有存储
+    std::shared_ptr<uint64_t> mapped{};       // 外部存储（如 mmap 的迷宫文件），非空时取代 words；拷贝时共享
+    size_t mappedWords = 0;
+    int32_t width{}, height{};
+    MazeLayout layout = MazeLayout::RowMajor;
+    int32_t tilesPerRow{};                    // Tiled8x8: 每行块数
+
+    static constexpr size_t WordBits = 64;
+    static constexpr int32_t TileSide = 8;
+
+    void Resize(int32_t w, int32_t h, bool wall, MazeLayout l = MazeLayout::RowMajor) {
+        width = w;
+        height = h;
+        layout = l;
+
+        size_t count = 0;
+        if (layout == MazeLayout::Tiled8x8)
+        {
+            tilesPerRow = (w + TileSide - 1) / TileSide;
+            count = (size_t)tilesPerRow * (size_t)((h + TileSide - 1) / TileSide);
+        }
+        else
+        {
+            tilesPerRow = 0;
+            count = ((size_t)w * (size_t)h + WordBits - 1) / WordBits;
+        }
+        mapped.reset();
+        mappedWords = 0;
+        words.assign(count, wall ? ~0ull : 0ull);
+        if (!wall) MarkPadding();
+    }
+
+    uint64_t* Data()             { return mapped ? mapped.get() : words.data(); }
+    const uint64_t* Data() const { return mapped ? mapped.get() : words.data(); }
+    size_t WordCount() const     { return mapped ? mappedWords : words.size(); }
+
+    // 逻辑坐标 -> 位下标
+    size_t BitIndex(int32_t x, int32_t y) const {
+        if (layout == MazeLayout::Tiled8x8)
+        {
+            const size_t tile = (size_t)(y / TileSide) * (size_t)tilesPerRow + (size_t)(x / TileSide);
+            return tile * WordBits + (size_t)((y % TileSide) * TileSide + (x % TileSide));
+        }
+        return (size_t)y * (size_t)width + (size_t)x;
+    }
+
+    bool TestBit(size_t bit) const { return (Data()[bit / WordBits] >> (bit % WordBits)) & 1ull; }
+    void SetBit(size_t bit)        { Data()[bit / WordBits] |= 1ull << (bit % WordBits); }
+    void ClearBit(size_t bit)      { Data()[bit / WordBits] &= ~(1ull << (bit % WordBits)); }
+
+    bool Test(int32_t x, int32_t y) const { return TestBit(BitIndex(x, y)); }
+    void Set(int32_t x, int32_t y)        { SetBit(BitIndex(x, y)); }
+    void Clear(int32_t x, int32_t y)      { ClearBit(BitIndex(x, y)); }
+
+    // 行主序线性下标 idx = y * width + x
+    bool TestAt(size_t idx) const {
+        if (layout == MazeLayout::RowMajor) return TestBit(idx);
+        return Test((int32_t)(idx % (size_t)width), (int32_t)(idx / (size_t)width));
+    }
+
+    // 第 y 行从 x 开始向右 64 格的墙位，bit i 对应 (x + i, y)；超出行尾的位视为墙
+    uint64_t Segment(int32_t x, int32_t y) const {
+        if (layout == MazeLayout::Tiled8x8)
+            return TiledSegment(x, y);
+
+        const uint64_t* data = Data();
+        const size_t bit = BitIndex(x, y);
+        const size_t wi = bit / WordBits;
+        const size_t sh = bit % WordBits;
+
+        uint64_t v = data[wi] >> sh;
+        if (sh)
+            v |= (wi + 1 < WordCount()) ? (data[wi + 1] << (WordBits - sh)) : (~0ull << (WordBits - sh));
+
+        const int32_t remain = width - x;
+        if (remain < (int32_t)WordBits)
+            v |= ~0ull << remain;
+        return v;
+    }
+
+    // Segment 的反向：整行写入，row[i] 的 bit j 对应 (64i + j, y)，共 (width + 63) / 64 个字，超出行尾的位忽略
+    void StoreRow(int32_t y, std::span<const uint64_t> row) {
+        uint64_t* data = Data();
+        for (size_t i = 0; (int32_t)(i * WordBits) < width; ++i)
+        {
+            const int32_t x = (int32_t)(i * WordBits);
+            const uint32_t n = (uint32_t)std::min<int32_t>(width - x, (int32_t)WordBits);
+            const uint64_t keep = (n == WordBits) ? ~0ull : ((1ull << n) - 1);
+            const uint64_t v = row[i] & keep;
+
+            if (layout == MazeLayout::Tiled8x8)
+            {
+                // 逐块写 8 位
+                const size_t rowBase = (size_t)(y / TileSide) * (size_t)tilesPerRow;
+                const int32_t rowShift = (y % TileSide) * TileSide;
+                for (uint32_t k = 0; k < n; k += TileSide)
+                {
+                    uint64_t& w = data[rowBase + (size_t)((x + (int32_t)k) / TileSide)];
+                    const uint64_t mask = ((keep >> k) & 0xFFull) << rowShift;
+                    w = (w & ~mask) | (((v >> k) & 0xFFull) << rowShift);
+                }
+                continue;
+            }
+
+            const size_t bit = BitIndex(x, y);
+            const size_t wi = bit / WordBits;
+            const uint32_t sh = (uint32_t)(bit % WordBits);
+            data[wi] = (data[wi] & ~(keep << sh)) | (v << sh);
+            if (sh + n > WordBits)
+            {
+                const uint32_t done = (uint32_t)WordBits - sh;
+                data[wi + 1] = (data[wi + 1] & ~(keep >> done)) | (v >> done);
+            }
+        }
+    }
+
+    size_t WallCount() const {
+        const uint64_t* data = Data();
+        size_t n = 0;
+        for (size_t i = 0; i < WordCount(); ++i) n += (size_t)std::popcount(data[i]);
+        const size_t bits = (size_t)width * (size_t)height;
+        return n - (WordCount() * WordBits - bits);
+    }
+
+    size_t MemoryBytes() const {
+        return WordCount() * sizeof(uint64_t);
+    }
+
+private:
+    // 块内一行是 8 位：逐块拼出 64 位
+    uint64_t TiledSegment(int32_t x, int32_t y) const {
+        const size_t rowBase = (size_t)(y / TileSide) * (size_t)tilesPerRow;
+        const int32_t rowShift = (y % TileSide) * TileSide;
+
+        const uint64_t* data = Data();
+        uint64_t v = 0;
+        int32_t got = 0;
+        int32_t cx = x;
+        while (got < (int32_t)WordBits && cx < width)
+        {
+            const uint64_t w = data[rowBase + (size_t)(cx / TileSide)];
+            const int32_t sh = cx % TileSide;
+            const uint64_t part = ((w >> rowShift) & 0xFFull) >> sh;   // 块右侧填充位恒为 1
+
+            v |= part << got;
+            got += TileSide - sh;
+            cx += TileSide - sh;
+        }
+        if (got < (int32_t)WordBits)
+            v |= ~0ull << got;
+        return v;
+    }
+
+    // 不属于任何格子的位恒为 1，越界读到的都是墙
+    void MarkPadding() {
+        if (layout == MazeLayout::RowMajor)
+        {
+            const size_t bits = (size_t)width * (size_t)height;
+            if (bits % WordBits)
+                words.back() |= ~0ull << (bits % WordBits);
+            return;
+        }
+
+        const int32_t paddedW = tilesPerRow * TileSide;
+        const int32_t paddedH = (int32_t)(WordCount() / (size_t)std::max(tilesPerRow, 1)) * TileSide;
+        for (int32_t y = 0; y < paddedH; ++y)
+            for (int32_t x = (y < height) ? width : 0; x < paddedW; ++x)
+                SetBit(BitIndex(x, y));
+    }
+};
+
+// 房间级结构信息：度数（打通的方向数）、死路、路口、走廊
+// 由 MazeBuilder::Analyze 计算（BuildOptions::structure 打开时 Build 顺带算好）；之后再改墙不会自动更新
+struct MazeStructure
+{
+    // 一条走廊：两端是非度数 2 的房间（死路 / 路口），中间房间度数都为 2；length 为格子步数
+    struct Corridor
+    {
+        Point a, b;
+        int32_t length;
+    };
+
+    int32_t roomsW{}, roomsH{};
+    std::vector<uint8_t> degree{};        // 房间 (rx, ry) 的度数，下标 ry * roomsW + rx
+    std::vector<Point> deadEnds{};        // 度数 1 的房间（格子坐标，行主序）
+    std::vector<Point> junctions{};       // 度数 >= 3 的房间
+    std::vector<Corridor> corridors{};
+
+    bool Empty() const {
+        return degree.empty();
+    }
+
+    // (x, y) 为房间的格子坐标（奇数）
+    uint8_t Degree(int32_t x, int32_t y) const {
+        return degree[(size_t)(y / 2) * (size_t)roomsW + (size_t)(x / 2)];
+    }
+
+    void Clear() {
+        roomsW = roomsH = 0;
+        degree.clear();
+        deadEnds.clear();
+        junctions.clear();
+        corridors.clear();
+    }
+};
+
 struct Maze{
-    std::vector<std::vector<int32_t>> grid{};
+    WallBitmap walls{};
     int32_t seed{};
-    int32_t width, height;
+    MazeGenerator generator = MazeGenerator::Backtracker;
+    std::chrono::microseconds buildTime{};    // 生成耗时（含分配位图），从文件打开时为 0
+    int32_t width{}, height{};
     Point start, end;
+    MazeStructure structure{};                // 仅在 BuildOptions::structure 时填写
+
+    // 按尺寸重新分配墙体位图，wall=true 时全部为墙
+    void Resize(int32_t w, int32_t h, bool wall, MazeLayout layout = MazeLayout::RowMajor) {
+        width = w;
+        height = h;
+        walls.Resize(w, h, wall, layout);
+    }
+
+    bool Empty() const {
+        return width <= 0 || height <= 0;
+    }
+
+    size_t CellCount() const {
+        return (size_t)width * (size_t)height;
+    }
+
+    // 二维坐标 <-> 线性下标
+    size_t Index(int32_t x, int32_t y) const {
+        return (size_t)y * (size_t)width + (size_t)x;
+    }
+
+    Point ToPoint(size_t idx) const {
+        return { (int32_t)(idx % (size_t)width), (int32_t)(idx / (size_t)width) };
+    }
 
     bool InBounds(int32_t x, int32_t y) const {
-        return x >= 0 && y >= 0 && y < (int32_t)grid.size() && x < (int32_t)grid[0].size();
+        return x >= 0 && y >= 0 && x < width && y < height;
     }
 
     bool IsWall(int32_t x, int32_t y) const {
-        return InBounds(x, y) ? grid[y][x] == 1 : true;
+        return InBounds(x, y) ? walls.Test(x, y) : true;
+    }
+
+    bool IsWallAt(size_t idx) const {
+        return walls.TestAt(idx);
+    }
+
+    void SetWall(int32_t x, int32_t y, bool wall) {
+        if (wall) walls.Set(x, y);
+        else      walls.Clear(x, y);
     }
     
-};
\ No newline at end of file
+};
+
+// 只读、非拥有的迷宫视图：算法入口统一接收它，按值传递只拷贝指针和尺寸
+struct MazeView
+{
+    const WallBitmap* walls = nullptr;
+    int32_t width{}, height{};
+    Point start{}, end{};
+
+    MazeView() = default;
+    MazeView(const Maze& maze)
+        : walls(&maze.walls), width(maze.width), height(maze.height), start(maze.start), end(maze.end) {}
+
+    size_t CellCount() const {
+        return (size_t)width * (size_t)height;
+    }
+
+    size_t Index(int32_t x, int32_t y) const {
+        return (size_t)y * (size_t)width + (size_t)x;
+    }
+
+    bool InBounds(int32_t x, int32_t y) const {
+        return x >= 0 && y >= 0 && x < width && y < height;
+    }
+
+    bool IsWall(int32_t x, int32_t y) const {
+        return InBounds(x, y) ? walls->Test(x, y) : true;
+    }
+
+    bool IsWallAt(size_t idx) const {
+        return walls->TestAt(idx);
+    }
+};
+
+// 带一圈哨兵墙的字节网格：(width+2) x (height+2)，外圈恒为 Ring
+// 邻居用线性偏移 +1 / -1 / +stride / -stride，热循环里不需要越界检查
+struct PaddedGrid
+{
+    static constexpr uint8_t Open = 0;
+    static constexpr uint8_t Wall = 1;
+    static constexpr uint8_t Ring = 2;   // 哨兵，不可破
+
+    std::vector<uint8_t> cells{};
+    int32_t width{}, height{};           // 原迷宫尺寸（不含外圈）
+    int32_t stride{};                    // width + 2
+    std::array<int32_t, 4> offsets{};    // 与 dx = {1,-1,0,0}, dy = {0,0,1,-1} 同序
+
+    static PaddedGrid FromMaze(MazeView maze) {
+        PaddedGrid g;
+        g.Assign(maze);
+        return g;
+    }
+
+    // 原地重建，容量够时不重新分配
+    void Assign(MazeView maze) {
+        width = maze.width;
+        height = maze.height;
+        stride = maze.width + 2;
+        offsets = { 1, -1, stride, -stride };
+        cells.assign((size_t)stride * (size_t)(maze.height + 2), Ring);
+
+        for (int32_t y = 0; y < maze.height; ++y)
+        {
+            uint8_t* row = cells.data() + Index(0, y);
+            for (int32_t x0 = 0; x0 < maze.width; x0 += (int32_t)WallBitmap::WordBits)
+            {
+                const uint64_t seg = maze.walls->Segment(x0, y);
+                const int32_t n = std::min<int32_t>((int32_t)WallBitmap::WordBits, maze.width - x0);
+                for (int32_t i = 0; i < n; ++i)
+                    row[x0 + i] = (uint8_t)((seg >> i) & 1ull);
+            }
+        }
+    }
+
+    size_t Index(int32_t x, int32_t y) const {
+        return (size_t)(y + 1) * (size_t)stride + (size_t)(x + 1);
+    }
+
+    Point ToPoint(size_t idx) const {
+        return { (int32_t)(idx % (size_t)stride) - 1, (int32_t)(idx / (size_t)stride) - 1 };
+    }
+
+    size_t Size() const {
+        return cells.size();
+    }
+};
+
+// 房间级表示：步长 2 的格点上每个房间 (2*rx+1, 2*ry+1) 用 4 位记录打通的方向
+// 两个房间共用一个字节；打通的边在两侧房间里各记一次，便于直接按位遍历邻居
+struct PassageGrid
+{
+    // 方向位，与 dx = {1,-1,0,0}, dy = {0,0,1,-1} 同序
+    static constexpr uint8_t East  = 1;
+    static constexpr uint8_t West  = 2;
+    static constexpr uint8_t South = 4;
+    static constexpr uint8_t North = 8;
+
+    static constexpr int32_t DirX[4] = { 1, -1, 0, 0 };
+    static constexpr int32_t DirY[4] = { 0, 0, 1, -1 };
+
+    std::vector<uint8_t> nibbles{};
+    int32_t roomsW{}, roomsH{};
+    int32_t seed{};
+    MazeGenerator generator = MazeGenerator::Backtracker;
+
+    void Resize(int32_t rw, int32_t rh) {
+        roomsW = rw;
+        roomsH = rh;
+        nibbles.assign(((size_t)rw * (size_t)rh + 1) / 2, 0);
+    }
+
+    size_t RoomCount() const { return (size_t)roomsW * (size_t)roomsH; }
+    size_t Room(int32_t rx, int32_t ry) const { return (size_t)ry * (size_t)roomsW + (size_t)rx; }
+
+    // 对应网格尺寸
+    int32_t GridWidth() const  { return roomsW * 2 + 1; }
+    int32_t GridHeight() const { return roomsH * 2 + 1; }
+
+    uint8_t Mask(size_t room) const {
+        return (uint8_t)((nibbles[room / 2] >> ((room % 2) * 4)) & 0xF);
+    }
+
+    void AddMask(size_t room, uint8_t bits) {
+        nibbles[room / 2] |= (uint8_t)(bits << ((room % 2) * 4));
+    }
+
+    // 打通 (rx, ry) 朝 dir 方向的墙，同时写入对侧房间
+    void Open(int32_t rx, int32_t ry, int dir) {
+        static constexpr uint8_t opposite[4] = { West, East, North, South };
+        AddMask(Room(rx, ry), (uint8_t)(1u << dir));
+        AddMask(Room(rx + DirX[dir], ry + DirY[dir]), opposite[dir]);
+    }
+
+    // 无损展开为墙体网格，用于渲染和格子级算法
+    Maze ToMaze(MazeLayout layout = MazeLayout::RowMajor) const {
+        Maze maze;
+        maze.seed = seed;
+        maze.generator = generator;
+        maze.Resize(GridWidth(), GridHeight(), true, layout);
+
+        for (int32_t ry = 0; ry < roomsH; ++ry)
+        {
+            for (int32_t rx = 0; rx < roomsW; ++rx)
+            {
+                const int32_t x = rx * 2 + 1;
+                const int32_t y = ry * 2 + 1;
+                const uint8_t m = Mask(Room(rx, ry));
+                maze.SetWall(x, y, false);
+                if (m & East)  maze.SetWall(x + 1, y, false);
+                if (m & South) maze.SetWall(x, y + 1, false);
+            }
+        }
+        return maze;
+    }
+
+    // 从网格读回房间掩码；只识别房间之间的缝，柱子格 (偶, 偶) 上的开口无法表示，会被丢弃
+    static PassageGrid FromMaze(const Maze& maze) {
+        PassageGrid g;
+        g.seed = maze.seed;
+        g.generator = maze.generator;
+        g.Resize(std::max(0, (maze.width - 1) / 2), std::max(0, (maze.height - 1) / 2));
+
+        for (int32_t ry = 0; ry < g.roomsH; ++ry)
+        {
+            for (int32_t rx = 0; rx < g.roomsW; ++rx)
+            {
+                const int32_t x = rx * 2 + 1;
+                const int32_t y = ry * 2 + 1;
+                if (maze.IsWall(x, y)) continue;
+                if (rx + 1 < g.roomsW && !maze.IsWall(x + 1, y) && !maze.IsWall(x + 2, y)) g.Open(rx, ry, 0);
+                if (ry + 1 < g.roomsH && !maze.IsWall(x, y + 1) && !maze.IsWall(x, y + 2)) g.Open(rx, ry, 2);
+            }
+        }
+        return g;
+    }
+};
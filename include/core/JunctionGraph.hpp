@@ -0,0 +1,87 @@
+#pragma once
+#include "core/Common.hpp"
+#include "core/DataStruct.hpp"
+
+// 走廊收缩后的路口图：通路格里度数不为 2 的（路口、死路、孤立格）是节点，
+// 两节点之间只经过度数 2 格子的走廊收成一条带权边（权 = 步数），拐弯的走廊也算一条。
+// 只由度数 2 格子组成的环没有可停的地方，取环上行主序最小的格子补作节点。
+// 邻接按 CSR 存：节点 u 的出边是 [EdgeBegin(u), EdgeEnd(u))，每条走廊两个方向各一条；
+// 边只记终点、权和从起点迈出的第一步方向，展开成格子时沿哨兵网格重走（走廊里每格只有一个去向）。
+// 每个迷宫建一次，之后的查询只读；搜索见 PathFinder::pathFinder(const JunctionGraph&, ...)
+class JunctionGraph
+{
+public:
+    static constexpr uint32_t NoNode = UINT32_MAX;
+    static constexpr size_t NoCell = SIZE_MAX;
+
+    JunctionGraph() = default;
+    explicit JunctionGraph(MazeView maze) { Build(maze); }
+
+    // 按迷宫重建（容量复用）；迷宫的墙变了要重建
+    void Build(MazeView maze);
+
+    const PaddedGrid& Grid() const { return grid; }
+
+    size_t NodeCount() const { return nodeCells.size(); }
+    size_t EdgeCount() const { return targets.size(); }   // 有向边
+    std::chrono::microseconds BuildTime() const { return buildTime; }
+    size_t MemoryBytes() const;
+
+    // 节点所在的哨兵网格下标（行主序递增）
+    size_t NodeCell(uint32_t node) const { return nodeCells[node]; }
+    bool IsNode(size_t cell) const { return (nodeBits[cell / 64] >> (cell % 64)) & 1ull; }
+    // 二分查找；不是节点返回 NoNode
+    uint32_t NodeOf(size_t cell) const;
+
+    uint32_t EdgeBegin(uint32_t node) const { return offsets[node]; }
+    uint32_t EdgeEnd(uint32_t node) const { return offsets[node + 1]; }
+    uint32_t Target(uint32_t edge) const { return targets[edge]; }
+    int32_t Weight(uint32_t edge) const { return weights[edge]; }
+    uint8_t Dir(uint32_t edge) const { return dirs[edge]; }
+
+    // 从 cell 沿方向 dir 迈一步后顺着走廊走，停在第一个节点或 stop 上；
+    // steps 为步数，lastDir 为最后一步的方向（反过来就是从到达点走回这条走廊的方向）
+    size_t Walk(size_t cell, int dir, size_t stop, int32_t& steps, int& lastDir) const {
+        return Follow(cell, dir, stop, steps, lastDir, [](size_t) {});
+    }
+
+    // 展开一段：从 from 沿 dir 走到 to，途经格子（不含 from，含 to）按顺序追加到 out
+    void Expand(size_t from, int dir, size_t to, std::vector<Point>& out) const {
+        int32_t steps = 0;
+        int lastDir = 0;
+        Follow(from, dir, to, steps, lastDir, [&](size_t cell) { out.push_back(grid.ToPoint(cell)); });
+    }
+
+private:
+    template<class Visit>
+    size_t Follow(size_t cell, int dir, size_t stop, int32_t& steps, int& lastDir, Visit&& visit) const {
+        const auto& off = grid.offsets;
+        steps = 0;
+        for (;;)
+        {
+            cell += off[dir];
+            ++steps;
+            lastDir = dir;
+            visit(cell);
+            if (cell == stop || IsNode(cell)) return cell;
+
+            // 度数 2：除来路外只有一个方向通
+            const int back = dir ^ 1;
+            for (int d = 0; d < 4; ++d)
+                if (d != back && grid.cells[cell + off[d]] == PaddedGrid::Open) { dir = d; break; }
+        }
+    }
+
+    int Degree(size_t cell) const;
+    void MarkNode(size_t cell) { nodeBits[cell / 64] |= 1ull << (cell % 64); }
+    void EmitEdges(std::vector<uint64_t>& walked);
+
+    PaddedGrid grid{};
+    std::vector<uint64_t> nodeBits{};     // 每格 1 位：是否节点
+    std::vector<size_t> nodeCells{};
+    std::vector<uint32_t> offsets{};      // CSR：NodeCount() + 1 项
+    std::vector<uint32_t> targets{};
+    std::vector<int32_t> weights{};
+    std::vector<uint8_t> dirs{};
+    std::chrono::microseconds buildTime{};
+};
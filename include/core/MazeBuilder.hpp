@@ -2,7 +2,86 @@
 #include "core/Common.hpp"
 #include "core/DataStruct.hpp"
 
+// 打环方式（在完美迷宫上再打通一些墙，制造多条路线）
+enum class BraidMode : uint8_t
+{
+    Walls,      // 在仍关着的房间间墙缝里等概率抽 braidRatio 比例打通
+    DeadEnds,   // 每个死路房间以 braidRatio 的概率再打通一面墙（优先连向另一个死路）
+                // 要逐房间数开口找死路，是 O(W*H) 的整图扫描（4001x4001 约 100 ms）；只有 Walls 是 O(k) 抽样
+};
+
+// 生成参数
+struct BuildOptions
+{
+    MazeLayout layout = MazeLayout::RowMajor;   // 墙体位图的内存布局（大迷宫可用分块布局）
+    MazeGenerator generator = MazeGenerator::Backtracker;
+    int32_t extraLoops = 10;                    // 生成完美迷宫后额外打通的墙数（制造多条路线）
+    BraidMode braid = BraidMode::Walls;
+    double braidRatio = 0.0;                    // [0, 1]，含义见 BraidMode；extraLoops 在此之外再打通
+
+    // 分块并行：>0 时把房间平面切成 tileRooms x tileRooms 的块，各块独立生成后按种子确定地缝合
+    // 结果只取决于 seed / 尺寸 / generator / tileRooms，与 threads 无关（但与 tileRooms=0 的整体生成不同）
+    int32_t tileRooms = 0;
+    int32_t threads = 0;                        // 分块模式的工作线程数，0 = 硬件线程数
+
+    bool structure = false;                     // 同时算出 Maze::structure（度数 / 死路 / 路口 / 走廊）
+};
+
+// 流式生成的行输出：y 为网格行号（从 0 递增），row 为该行墙位，bit i 对应 (i, y)，1=墙
+// row 只在回调期间有效，共 (width + 63) / 64 个字，末字超出行宽的位为 1
+using MazeRowSink = std::function<void(int32_t y, std::span<const uint64_t> row)>;
+
+// 批量生成的输出：index 为 seeds 中的下标。在工作线程上并发调用，须自行保证线程安全；
+// maze 是该线程复用的缓冲，只在回调期间有效
+using MazeBatchSink = std::function<void(size_t index, const Maze& maze)>;
+
 class MazeBuilder {
 public:
-    static Maze Build(int seed);    
-};
\ No newline at end of file
+    static constexpr int32_t DefaultSize = 41;
+    static constexpr int32_t MinSide = 3;
+    static constexpr int32_t MaxSide = 100001;
+
+    static constexpr int32_t GeneratorCount = (int32_t)MazeGenerator::SidewinderSimd + 1;
+    static const char* GeneratorName(MazeGenerator generator);
+
+    // 边长规整到 [MinSide, MaxSide] 内的奇数（房间在奇数坐标上，外圈必须是墙）
+    static int32_t NormalizeSide(int32_t side);
+
+    // 任意宽高，options.generator 选择生成算法，耗时记在 Maze::buildTime
+    // 位图约 width*height/8 字节；各算法的临时内存见 MazeGenerator 的注释
+    static Maze Build(int seed, int32_t width, int32_t height, const BuildOptions& options = {});
+
+    // 同上，写进已有的 maze：尺寸与布局不变时复用它的位图内存
+    static void Build(int seed, int32_t width, int32_t height, const BuildOptions& options, Maze& maze);
+
+    // DefaultSize x DefaultSize
+    static Maze Build(int seed, MazeLayout layout = MazeLayout::RowMajor);
+
+    // 从墙体位图算房间级结构信息，out 的内存可复用；度数按 64 格一段读位图，走廊每个房间只走一次
+    static void Analyze(const WallBitmap& walls, MazeStructure& out);
+
+    // 批量生成：seeds 分给 threads 个工作线程（0 = 硬件线程数），每个线程复用一份迷宫缓冲，结果逐个交给 sink
+    // 每个迷宫与单独调用 Build(seed, ...) 逐位一致；分块模式（options.tileRooms > 0）下宜令 options.threads = 1
+    static void BuildBatch(std::span<const int> seeds, int32_t width, int32_t height, const BuildOptions& options,
+                           int32_t threads, const MazeBatchSink& sink);
+
+    // 全部留在内存里，按 seeds 的顺序返回
+    static std::vector<Maze> BuildBatch(std::span<const int> seeds, int32_t width, int32_t height,
+                                        const BuildOptions& options = {}, int32_t threads = 0);
+
+    // 直接在房间格点上生成，输出 4 位/房间的通道掩码；ToMaze() 与同参数的 Build() 结果一致
+    static PassageGrid BuildPassages(int seed, int32_t width, int32_t height, const BuildOptions& options = {});
+    static PassageGrid BuildPassages(int seed);
+
+    // Eller 算法逐行生成并交给 sink，常驻内存只有当前房间行的集合编号，O(width)
+    // 高度不受 MaxSide 限制（只规整为奇数）；不做打环，结果与 generator=Eller、extraLoops=0 的 Build() 一致
+    // 实测 4001x40001 单线程约 17 MB/s 位图（约 28 ns/房间），比顺序写盘（约 1.2 GB/s）慢两个数量级：
+    // 行展开已按字处理，剩下的开销在逐房间的集合编号（并查集 + 强制向南），写文件时瓶颈是生成而不是磁盘
+    static void BuildStream(int seed, int32_t width, int32_t height, const MazeRowSink& sink);
+
+    // 无限分块世界（见 ChunkWorld）的一块：有效区域 2*chunkRooms 见方，房间仍在奇数坐标上，第 0 行 / 第 0 列是与北、西邻块的接缝
+    // 位图多出的最后一行一列恒为墙，只是生成时的边界，读取时应忽略
+    // 块内是完美迷宫，两条接缝各开一个口；结果只取决于 (seed, cx, cy, chunkRooms, generator)
+    static void BuildChunk(int seed, int32_t cx, int32_t cy, int32_t chunkRooms, MazeGenerator generator,
+                           WallBitmap& walls);
+};
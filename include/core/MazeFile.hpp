@@ -0,0 +1,157 @@
+#pragma once
+#include "core/Common.hpp"
+#include "core/DataStruct.hpp"
+
+#include <fstream>
+#include <mutex>
+
+// 迷宫二进制文件格式（小端）：
+//   [MazeFileHeader][MazeFileBand x bandCount][填充到 4096 对齐][墙体位图字数组]
+// 位图字数组与 WallBitmap 的内存布局完全一致，打开时直接 mmap，不做拷贝
+struct MazeFileHeader
+{
+    char     magic[4];          // "MAZE"
+    uint32_t version;           // MazeFile::Version
+    int32_t  width, height;
+    int32_t  seed;
+    uint32_t generator;         // MazeGenerator
+    uint32_t layout;            // MazeLayout
+    int32_t  startX, startY;
+    int32_t  endX, endY;
+    uint32_t bandRows;          // 目录中每个条带覆盖的行数
+    uint64_t bandCount;
+    uint64_t directoryOffset;   // MazeFileBand 数组的文件偏移
+    uint64_t dataOffset;        // 位图字数组的文件偏移（页对齐）
+    uint64_t wordCount;
+};
+
+// 条带目录：第 i 个条带覆盖行 [i * bandRows, (i + 1) * bandRows)
+struct MazeFileBand
+{
+    uint64_t firstWord;
+    uint64_t wordCount;
+};
+
+class MazeFile
+{
+    public:
+        static constexpr uint32_t Version  = 1;
+        static constexpr uint32_t BandRows = 64;   // 64 行：两种布局下条带都按字对齐
+
+        // 写出迷宫文件，失败抛 std::runtime_error
+        static void Save(const Maze& maze, const std::string& path);
+
+        // 以私有映射打开迷宫文件：页面按需载入，修改不会写回文件
+        static Maze Open(const std::string& path);
+
+        // 提示内核预读 [y0, y1) 行所在的条带（仅对映射打开的迷宫有效）
+        static void Prefetch(const Maze& maze, int32_t y0, int32_t y1);
+
+        // 读取文件头与条带目录（不映射位图）
+        static std::pair<MazeFileHeader, std::vector<MazeFileBand>> ReadDirectory(const std::string& path);
+
+        // 第 band 个条带在位图字数组中的范围
+        static MazeFileBand BandRange(const WallBitmap& walls, uint64_t band);
+};
+
+// 按行流式写出行主序迷宫文件：头和目录在构造时写好，位图逐行追加，内存里只有一个未满的字
+// 与 MazeBuilder::BuildStream 配合可生成超出内存的迷宫，写出的文件可直接 MazeFile::Open
+class MazeFileWriter
+{
+    public:
+        // 失败抛 std::runtime_error
+        MazeFileWriter(const std::string& path, int32_t width, int32_t height, int32_t seed,
+                       MazeGenerator generator, Point start, Point end);
+
+        // 追加下一行：bit i 对应 (i, y)，只取前 width 位
+        void WriteRow(std::span<const uint64_t> row);
+
+        // 补齐最后一个字并检查行数；未调用时文件不完整
+        void Finish();
+
+        int32_t RowsWritten() const { return rows; }
+
+    private:
+        void Put(uint64_t word);
+
+        std::ofstream out;
+        std::string path;
+        int32_t width = 0, height = 0;
+        int32_t rows = 0;
+        uint64_t acc = 0;      // 尚未凑满 64 位的尾部
+        uint32_t accBits = 0;
+};
+
+// 迷宫语料文件（小端）：一批同尺寸、同生成参数的迷宫，按 seed 取用
+//   [MazeCorpusHeader][各迷宫的位图字数组，按写入顺序首尾相接][MazeCorpusEntry x count，按 seed 升序]
+// 位图字数组与 WallBitmap 的内存布局一致，打开时整文件 mmap，取出的迷宫直接指向映射
+struct MazeCorpusHeader
+{
+    char     magic[4];          // "MZCP"
+    uint32_t version;           // MazeCorpus::Version
+    int32_t  width, height;
+    uint32_t generator;         // MazeGenerator
+    uint32_t layout;            // MazeLayout
+    int32_t  startX, startY;
+    int32_t  endX, endY;
+    uint64_t wordsPerMaze;
+    uint64_t count;
+    uint64_t indexOffset;       // MazeCorpusEntry 数组的文件偏移
+};
+
+struct MazeCorpusEntry
+{
+    int32_t  seed;
+    uint32_t reserved;
+    uint64_t offset;            // 该迷宫位图的文件偏移
+};
+
+// 以私有映射打开语料文件；拷贝时共享同一映射
+class MazeCorpus
+{
+    public:
+        static constexpr uint32_t Version = 1;
+
+        // 失败抛 std::runtime_error
+        static MazeCorpus Open(const std::string& path);
+
+        const MazeCorpusHeader& Header() const { return header; }
+        size_t Count() const { return (size_t)header.count; }
+
+        // 索引中第 i 个（seed 升序）
+        int32_t SeedAt(size_t i) const { return index[i].seed; }
+        Maze At(size_t i) const;
+
+        // 按 seed 二分查找，找不到返回空迷宫
+        Maze Find(int32_t seed) const;
+
+    private:
+        std::shared_ptr<char> base;
+        MazeCorpusHeader header{};
+        const MazeCorpusEntry* index = nullptr;
+};
+
+// 语料文件写出：迷宫到一个追加一个，索引留在内存里，Finish 时排序写到文件尾
+class MazeCorpusWriter
+{
+    public:
+        // 所有迷宫共用的尺寸、布局、生成器与起终点；失败抛 std::runtime_error
+        MazeCorpusWriter(const std::string& path, int32_t width, int32_t height, MazeGenerator generator,
+                         MazeLayout layout, Point start, Point end);
+
+        // 追加一个迷宫（尺寸、布局须与构造参数一致）；可在多个线程上同时调用
+        void Add(const Maze& maze);
+
+        // 写出按 seed 排序的索引并回填文件头；未调用时文件不完整
+        void Finish();
+
+        uint64_t Count() const;
+
+    private:
+        mutable std::mutex lock;
+        std::ofstream out;
+        std::string path;
+        MazeCorpusHeader header{};
+        std::vector<MazeCorpusEntry> index;
+        uint64_t offset = 0;
+};
@@ -1,33 +1,256 @@
 #pragma once
 #include "core/Common.hpp"
+#include "core/BucketQueue.hpp"
 #include "core/DataStruct.hpp"
 
+// 路径 / 破墙结果：可直接 move 走，也可作为输出缓冲反复传入（clear 保留容量）
+struct SearchResult
+{
+    std::vector<Point> path;      // 路径点（含起终点）
+    std::vector<Point> visited;   // 按访问顺序记录的点，用于动画
+    int32_t length = 0;
+    int32_t expanded = 0;         // 从开放表弹出并展开的节点数（JPS 只有跳点）
+    std::chrono::milliseconds elapsed{};
+
+    void Clear()
+    {
+        path.clear();
+        visited.clear();
+        length = 0;
+        expanded = 0;
+        elapsed = {};
+    }
+};
+
+// 路径计数结果
+struct CountResult
+{
+    std::vector<std::vector<Point>> paths;
+    std::vector<int32_t> lengths;
+    int32_t ways = 0;
+    std::chrono::milliseconds elapsed{};
+
+    void Clear()
+    {
+        paths.clear();
+        lengths.clear();
+        ways = 0;
+        elapsed = {};
+    }
+};
+
+// 强制经过某点的结果：两段的访问记录分开保存
+struct PassResult
+{
+    std::vector<Point> path;
+    std::vector<Point> visitedToMid;     // 起点 -> 经过点
+    std::vector<Point> visitedFromMid;   // 经过点 -> 终点
+    int32_t length = 0;
+    std::chrono::milliseconds elapsed{};
+
+    void Clear()
+    {
+        path.clear();
+        visitedToMid.clear();
+        visitedFromMid.clear();
+        length = 0;
+        elapsed = {};
+    }
+};
+
+// A* 开放表的实现：
+// BinaryHeap 与原来的 std::priority_queue 出堆顺序相同（StaticSolver 也按它对齐）；
+// Buckets 按 f 值分桶（f 是小整数，一致启发下出队单调不减），push / pop 均摊 O(1)，同 f 后进先出，
+// 路径长度相同，但同长路径之间的选择和访问顺序可能不同
+enum class OpenListPolicy : uint8_t
+{
+    BinaryHeap,
+    Buckets,
+};
+
+// 已 Bind 迷宫上的搜索方式：
+// AStar 逐格扩展；JumpPoint 沿直走廊一口气跳到下一个岔路 / 拐角 / 起终点，只把这些跳点放进开放表，
+// 死胡同直接丢弃；Bidirectional 从起终点两头各跑一个 A*、轮流展开，访问记录两侧交错。
+// 三者路径长度相同（都是最短），JPS 的路径按跳点间的直线段展开回逐格
+enum class SearchMode : uint8_t
+{
+    AStar,
+    JumpPoint,
+    Bidirectional,
+};
+inline constexpr int SearchModeCount = 3;
+
+// A* 的可复用工作区：按格平铺的 g 值、每格 2 位的来向、访问纪元
+// 每次查询只把纪元加一，stamp 不等于当前纪元的格子视为未访问，所以查询之间什么都不用清
+// 同一个工作区在同一个（或不更大的）迷宫上反复查询，预热后不再分配内存。非线程安全，每个线程各用一个
+struct SearchContext
+{
+    struct OpenNode
+    {
+        Point p;
+        size_t idx;
+        int32_t g;
+        int32_t f;
+    };
+
+    PaddedGrid grid{};                  // Bind 时从迷宫拷入；迷宫的墙变了要重新 Bind
+    std::vector<int32_t> g{};           // 起点到该格的代价，stamp == epoch 时才有效
+    std::vector<uint32_t> stamp{};
+    std::vector<uint8_t> parent{};      // 每字节 4 格，每格 2 位：从哪个方向走进来（与 offsets 同序）
+    std::vector<OpenNode> open{};       // BinaryHeap 的堆存储
+    BucketQueue<OpenNode> buckets{};    // Buckets 的桶，键为 f
+
+    // Bidirectional 的反向一侧（从终点出发），含义同上；只在用到时才扩容
+    std::vector<int32_t> gBack{};
+    std::vector<uint32_t> stampBack{};
+    std::vector<uint8_t> parentBack{};
+    std::vector<OpenNode> openBack{};
+    BucketQueue<OpenNode> bucketsBack{};
+
+    std::vector<uint32_t> via{};        // JunctionGraph 上搜索：每个节点的上一个节点（来向仍记在 parent）
+
+    // BreakWalls 的分层状态，键 = 已破墙数 * grid.Size() + 格子：每个状态 1 字节纪元 + 2 位来向，按层数扩
+    std::vector<uint8_t> layerStamp{};
+    std::vector<uint8_t> layerParent{};
+
+    uint32_t epoch = 0;
+    uint8_t layerEpoch = 0;
+    OpenListPolicy openList = OpenListPolicy::BinaryHeap;
+    SearchMode mode = SearchMode::AStar;
+
+    // 按迷宫重建哨兵网格并把各数组扩到够用（只增不减）
+    void Bind(MazeView maze) {
+        grid.Assign(maze);
+        Reserve(grid.Size());
+    }
+
+    // g / stamp / parent 至少 n 项；图上搜索按节点数调用
+    void Reserve(size_t n) {
+        if (g.size() < n)
+        {
+            g.resize(n);
+            stamp.resize(n, 0);
+            parent.resize((n + 3) / 4);
+        }
+    }
+
+    void ReserveBack() {
+        const size_t n = grid.Size();
+        if (gBack.size() < n)
+        {
+            gBack.resize(n);
+            stampBack.resize(n, 0);
+            parentBack.resize((n + 3) / 4);
+        }
+    }
+
+    bool Bound() const { return !grid.cells.empty(); }
+
+    // 迷宫上个别格子的墙变了（如起终点被打通）：只改哨兵网格里的这一格，不必重新 Bind
+    void SetWall(Point p, bool wall) {
+        grid.cells[grid.Index(p.x, p.y)] = wall ? PaddedGrid::Wall : PaddedGrid::Open;
+    }
+
+    // 开始新一轮查询；纪元回绕时才整表清零一次
+    void NextEpoch() {
+        if (++epoch == 0)
+        {
+            std::fill(stamp.begin(), stamp.end(), 0u);
+            std::fill(stampBack.begin(), stampBack.end(), 0u);
+            epoch = 1;
+        }
+        open.clear();
+        buckets.Clear();
+        openBack.clear();
+        bucketsBack.Clear();
+    }
+
+    // 开始一轮分层搜索：分层数组至少 layers 层；字节纪元每 255 轮回绕一次，那时整表清零
+    void NextLayerEpoch(size_t layers) {
+        const size_t n = grid.Size() * layers;
+        if (layerStamp.size() < n)
+        {
+            layerStamp.resize(n, 0);
+            layerParent.resize((n + 3) / 4);
+        }
+        if (++layerEpoch == 0)
+        {
+            std::fill(layerStamp.begin(), layerStamp.end(), (uint8_t)0);
+            layerEpoch = 1;
+        }
+    }
+
+    bool Seen(size_t idx) const { return stamp[idx] == epoch; }
+    bool SeenBack(size_t idx) const { return stampBack[idx] == epoch; }
+
+    uint8_t Parent(size_t idx) const { return GetDir(parent, idx); }
+    void SetParent(size_t idx, uint8_t dir) { PutDir(parent, idx, dir); }
+    uint8_t ParentBack(size_t idx) const { return GetDir(parentBack, idx); }
+    void SetParentBack(size_t idx, uint8_t dir) { PutDir(parentBack, idx, dir); }
+    bool SeenLayer(size_t key) const { return layerStamp[key] == layerEpoch; }
+    uint8_t LayerParent(size_t key) const { return GetDir(layerParent, key); }
+    void MarkLayer(size_t key, uint8_t dir) {
+        layerStamp[key] = layerEpoch;
+        PutDir(layerParent, key, dir);
+    }
+
+private:
+    static uint8_t GetDir(const std::vector<uint8_t>& dirs, size_t idx) {
+        return (uint8_t)((dirs[idx >> 2] >> ((idx & 3) * 2)) & 3);
+    }
+    static void PutDir(std::vector<uint8_t>& dirs, size_t idx, uint8_t dir) {
+        const uint32_t sh = (uint32_t)(idx & 3) * 2;
+        dirs[idx >> 2] = (uint8_t)((dirs[idx >> 2] & ~(3u << sh)) | ((uint32_t)dir << sh));
+    }
+};
+
+class JunctionGraph;
+
 class PathFinder
 {
     public:
-        static std::tuple<std::vector<Point>, std::vector<Point>, int32_t, std::chrono::milliseconds>
-        pathFinder(Maze maze);
+        static SearchResult pathFinder(MazeView maze);
+        static void pathFinder(MazeView maze, SearchResult& out);
+
+        // 用调用方的工作区：每次都先 Bind（拷一遍网格）再查；同一迷宫上反复查询用下面的重载
+        static void pathFinder(MazeView maze, SearchContext& ctx, SearchResult& out);
+        // 在已 Bind 的迷宫上查任意起终点；同一迷宫上的批量查询用这个，不重复拷网格
+        static void pathFinder(SearchContext& ctx, Point start, Point end, SearchResult& out);
+
+        // 在路口图上做 A*（边带权，启发仍是曼哈顿距离）：起终点可以在走廊中间，先沿走廊接到两端节点；
+        // 起终点须是通路格。路径展开回逐格，visited 只有出队的节点；ctx 只借用其数组和开放表，不需要 Bind
+        static void pathFinder(const JunctionGraph& graph, SearchContext& ctx, Point start, Point end, SearchResult& out);
+
+        // 房间级 BFS：直接按通道掩码的置位方向扩展，结果路径展开回格子坐标（含房间之间的缝）
+        static SearchResult pathFinder(const PassageGrid& passages, Point start, Point end);
+        static void pathFinder(const PassageGrid& passages, Point start, Point end, SearchResult& out);
 };
 
 class WallBreaker : public PathFinder
 {
     public:
-        static std::tuple<std::vector<Point>, std::vector<Point>, int32_t, std::chrono::milliseconds>
-        BreakWalls(Maze maze, int32_t breakCount);
+        static SearchResult BreakWalls(MazeView maze, int32_t breakCount);
+        static void BreakWalls(MazeView maze, int32_t breakCount, SearchResult& out);
+        // 在已 Bind 的工作区上破墙：（已破墙数，格子）状态平铺在 ctx 的分层数组里，查询之间不拷网格，预热后不分配
+        static void BreakWalls(SearchContext& ctx, Point start, Point end, int32_t breakCount, SearchResult& out);
 
 };
 
 class PathCounter : public PathFinder
 {
     public:
-        static std::tuple<std::pair<std::vector<std::vector<Point>>, std::vector<int32_t>>, int32_t, std::chrono::milliseconds>
-        CountPaths(Maze maze, Point start, Point end);
+        static CountResult CountPaths(MazeView maze, Point start, Point end);
+        static void CountPaths(MazeView maze, Point start, Point end, CountResult& out);
+        // 在已 Bind 的工作区上计数：当前路径上的格子临时在 ctx.grid 里标成墙，返回前恢复
+        static void CountPaths(SearchContext& ctx, Point start, Point end, CountResult& out);
 
 };
 
 class PathPasser : public PathFinder
 {
     public:
-        static std::tuple<std::vector<Point>, std::vector<Point>, std::vector<Point>, int32_t, std::chrono::milliseconds>
-        PassPath(Maze maze, uint32_t x, uint32_t y);
-};
\ No newline at end of file
+        static PassResult PassPath(MazeView maze, uint32_t x, uint32_t y);
+        static void PassPath(MazeView maze, uint32_t x, uint32_t y, PassResult& out);
+        // 在已 Bind 的工作区上求经过 mid 的路径：两段双向 BFS 各用一轮纪元，两侧记录在 ctx 的正反向数组里
+        static void PassPath(SearchContext& ctx, Point start, Point end, Point mid, PassResult& out);
+};
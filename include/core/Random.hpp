@@ -0,0 +1,172 @@
+#pragma once
+#include "core/Common.hpp"
+
+// 可移植的随机数层：生成器、整数区间、洗牌都在这里实现，只用定宽整数运算。
+// xoshiro256** 与 UniformBelow 是 constexpr，编译期生成的迷宫与运行期逐位一致
+// 标准库的 mt19937 虽然序列固定，但 uniform_int_distribution / std::shuffle 的实现各家不同，
+// 同一种子换个编译器就是另一个迷宫；用这里的函数可以保证跨平台逐位一致，迷宫可按种子缓存
+
+// SplitMix64：把一个 64 位种子展开成多个互不相关的状态字
+constexpr uint64_t SplitMix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256**：顺序生成用的主力，256 位状态，每次 64 位
+class Xoshiro256
+{
+public:
+    using result_type = uint64_t;
+
+    constexpr explicit Xoshiro256(uint64_t seed = 0) {
+        for (auto& w : s) w = SplitMix64(seed);
+    }
+
+    constexpr uint64_t Next64() {
+        const uint64_t result = std::rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = std::rotl(s[3], 45);
+        return result;
+    }
+
+    // 高 32 位质量更好
+    constexpr uint32_t Next32() { return (uint32_t)(Next64() >> 32); }
+
+    // 满足 UniformRandomBitGenerator，便于和标准算法对比
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~0ull; }
+    result_type operator()() { return Next64(); }
+
+private:
+    std::array<uint64_t, 4> s{};
+};
+
+// PCG32（XSH-RR）：状态只有 16 字节，适合大量独立的小流
+class Pcg32
+{
+public:
+    using result_type = uint32_t;
+
+    explicit Pcg32(uint64_t seed = 0, uint64_t stream = 0) : inc((stream << 1) | 1u) {
+        Next32();
+        state += seed;
+        Next32();
+    }
+
+    uint32_t Next32() {
+        const uint64_t old = state;
+        state = old * 6364136223846793005ull + inc;
+        const uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        return std::rotr(xorshifted, (int)(old >> 59));
+    }
+
+    uint64_t Next64() {
+        const uint64_t hi = Next32();
+        return (hi << 32) | Next32();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~0u; }
+    result_type operator()() { return Next32(); }
+
+private:
+    uint64_t state = 0;
+    uint64_t inc = 1;
+};
+
+// Philox4x32-10：计数器式生成器，输出是 (key, counter) 的纯函数，没有状态。
+// 按 (seed, tile, cell) 直接寻址，任意线程以任意顺序取同一个位置都得到同一组随机数
+struct Philox
+{
+    using Block = std::array<uint32_t, 4>;
+
+    static Block Rounds(Block ctr, std::array<uint32_t, 2> key) {
+        constexpr uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+        constexpr uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+
+        for (int r = 0; r < 10; ++r)
+        {
+            const uint64_t p0 = (uint64_t)M0 * ctr[0];
+            const uint64_t p1 = (uint64_t)M1 * ctr[2];
+            ctr = { (uint32_t)(p1 >> 32) ^ ctr[1] ^ key[0], (uint32_t)p1,
+                    (uint32_t)(p0 >> 32) ^ ctr[3] ^ key[1], (uint32_t)p0 };
+            key[0] += W0;
+            key[1] += W1;
+        }
+        return ctr;
+    }
+
+    // 128 位随机块：key = seed，counter = (cell, tile)
+    static Block At(uint64_t seed, uint64_t tile, uint64_t cell) {
+        return Rounds({ (uint32_t)cell, (uint32_t)(cell >> 32), (uint32_t)tile, (uint32_t)(tile >> 32) },
+                      { (uint32_t)seed, (uint32_t)(seed >> 32) });
+    }
+
+    static uint64_t At64(uint64_t seed, uint64_t tile, uint64_t cell) {
+        const Block b = At(seed, tile, cell);
+        return ((uint64_t)b[0] << 32) | b[1];
+    }
+};
+
+// [0, n) 上的均匀整数（n > 0）。n <= 2^32 用 Lemire 的乘法拒绝法，更大时用掩码拒绝
+template <class Rng>
+constexpr uint64_t UniformBelow(Rng& rng, uint64_t n)
+{
+    if (n > (1ull << 32))
+    {
+        const uint64_t mask = std::bit_ceil(n) - 1;
+        uint64_t x = rng.Next64() & mask;
+        while (x >= n) x = rng.Next64() & mask;
+        return x;
+    }
+    if (n == (1ull << 32))
+        return rng.Next32();
+
+    const uint32_t bound = (uint32_t)n;
+    uint64_t m = (uint64_t)rng.Next32() * bound;
+    uint32_t low = (uint32_t)m;
+    if (low < bound)
+    {
+        const uint32_t threshold = (0u - bound) % bound;
+        while (low < threshold)
+        {
+            m = (uint64_t)rng.Next32() * bound;
+            low = (uint32_t)m;
+        }
+    }
+    return m >> 32;
+}
+
+// [lo, hi] 上的均匀整数
+template <class Rng>
+int32_t UniformInt(Rng& rng, int32_t lo, int32_t hi)
+{
+    return lo + (int32_t)UniformBelow(rng, (uint64_t)((int64_t)hi - (int64_t)lo + 1));
+}
+
+// [0, 1) 上的均匀浮点，53 位精度
+template <class Rng>
+double UniformUnit(Rng& rng)
+{
+    return (double)(rng.Next64() >> 11) * 0x1.0p-53;
+}
+
+// Fisher-Yates 洗牌，替代 std::shuffle
+template <class It, class Rng>
+void Shuffle(It first, It last, Rng& rng)
+{
+    const auto n = last - first;
+    for (auto i = n - 1; i > 0; --i)
+    {
+        const auto j = (decltype(i))UniformBelow(rng, (uint64_t)i + 1);
+        std::iter_swap(first + i, first + j);
+    }
+}
@@ -0,0 +1,486 @@
+#pragma once
+#include "core/Common.hpp"
+#include "core/DataStruct.hpp"
+#include "core/MazeBuilder.hpp"
+#include "core/PathFinder.hpp"
+#include "core/Random.hpp"
+
+#include <climits>
+#include <stdexcept>
+
+// 编译期定尺寸的小迷宫：W x H 都是模板参数，格子存在 std::array 里（与 PaddedGrid 同样带一圈哨兵、同样编码），
+// 行跨度和邻居偏移都是常量，生成和求解的循环可以被编译器完全展开。
+// Generate 是 constexpr，可在编译期烤出基准用的固定迷宫，结果与 MazeBuilder::Build(seed, W, H) 逐位一致
+template <int32_t W, int32_t H>
+struct StaticMaze
+{
+    static_assert(W >= 3 && H >= 3 && (W % 2) == 1 && (H % 2) == 1, "StaticMaze: sides must be odd and >= 3");
+
+    static constexpr int32_t Width  = W;
+    static constexpr int32_t Height = H;
+    static constexpr int32_t Stride = W + 2;
+    static constexpr size_t  Size   = (size_t)Stride * (size_t)(H + 2);
+
+    // 求解器的临时状态（开放表、记录表、队列）都是 std::array 并用 16 位下标，只面向小迷宫（约 125x125 以内）
+    static_assert(Size <= (1u << 14), "StaticMaze: too large, use Maze");
+
+    static constexpr std::array<int32_t, 4> Offsets = { 1, -1, Stride, -Stride };   // 与 dx / dy 同序
+
+    std::array<uint8_t, Size> cells{};   // PaddedGrid::Open / Wall / Ring
+    int32_t seed{};
+    Point start{}, end{};
+
+    static constexpr size_t Index(int32_t x, int32_t y) {
+        return (size_t)(y + 1) * (size_t)Stride + (size_t)(x + 1);
+    }
+
+    static constexpr Point ToPoint(size_t idx) {
+        return { (int32_t)(idx % (size_t)Stride) - 1, (int32_t)(idx / (size_t)Stride) - 1 };
+    }
+
+    static constexpr bool InBounds(int32_t x, int32_t y) {
+        return x >= 0 && y >= 0 && x < W && y < H;
+    }
+
+    constexpr bool IsWall(int32_t x, int32_t y) const {
+        return !InBounds(x, y) || cells[Index(x, y)] != PaddedGrid::Open;
+    }
+
+    // 默认 BuildOptions 下的 Build：无栈回溯 + extraLoops 个环，起终点为左上 / 右下房间
+    static constexpr StaticMaze Generate(int seed);
+
+    // 从普通迷宫拷入，尺寸不符抛 std::runtime_error
+    static StaticMaze FromMaze(MazeView maze);
+
+    Maze ToMaze() const;
+};
+
+template <int32_t W, int32_t H>
+constexpr StaticMaze<W, H> StaticMaze<W, H>::Generate(int seed)
+{
+    constexpr int32_t RoomsW = (W - 1) / 2;
+    constexpr int32_t RoomsH = (H - 1) / 2;
+    constexpr uint8_t Linked = 0x10;   // 生成期间房间格 = Linked | 回父方向
+
+    StaticMaze m{};
+    m.seed = seed;
+    m.start = { 1, 1 };
+    m.end = { W - 2, H - 2 };
+    for (auto& c : m.cells) c = PaddedGrid::Ring;
+    for (int32_t y = 0; y < H; ++y)
+        for (int32_t x = 0; x < W; ++x)
+            m.cells[Index(x, y)] = PaddedGrid::Wall;
+
+    auto room = [](int32_t rx, int32_t ry) { return Index(rx * 2 + 1, ry * 2 + 1); };
+    auto inside = [](int32_t rx, int32_t ry) { return rx >= 0 && ry >= 0 && rx < RoomsW && ry < RoomsH; };
+
+    // 与 MazeBuilder 的 CarveBacktracker 同样的随机数消耗
+    Xoshiro256 rng((uint64_t)(uint32_t)seed);
+    int32_t cx = 0, cy = 0;
+    m.cells[room(0, 0)] = Linked;
+    while (true)
+    {
+        uint32_t open = 0;
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            const int32_t nx = cx + PassageGrid::DirX[dir];
+            const int32_t ny = cy + PassageGrid::DirY[dir];
+            if (inside(nx, ny) && m.cells[room(nx, ny)] == PaddedGrid::Wall) open |= 1u << dir;
+        }
+
+        if (open != 0)
+        {
+            const int n = std::popcount(open);
+            for (int k = (n == 1) ? 0 : (int)UniformBelow(rng, (uint64_t)n); k > 0; --k)
+                open &= open - 1;
+
+            const int dir = std::countr_zero(open);
+            m.cells[Index(cx * 2 + 1 + PassageGrid::DirX[dir], cy * 2 + 1 + PassageGrid::DirY[dir])] = PaddedGrid::Open;
+            cx += PassageGrid::DirX[dir];
+            cy += PassageGrid::DirY[dir];
+            m.cells[room(cx, cy)] = (uint8_t)(Linked | (dir ^ 1));
+            continue;
+        }
+        if (cx == 0 && cy == 0) break;
+
+        const int back = m.cells[room(cx, cy)] & 3;
+        cx += PassageGrid::DirX[back];
+        cy += PassageGrid::DirY[back];
+    }
+    for (int32_t ry = 0; ry < RoomsH; ++ry)
+        for (int32_t rx = 0; rx < RoomsW; ++rx)
+            m.cells[room(rx, ry)] = PaddedGrid::Open;
+
+    // 打环：与 MazeBuilder 的 Braid 相同的墙缝编号与抽样（braidRatio = 0）
+    constexpr uint64_t Rooms = (uint64_t)RoomsW * (uint64_t)RoomsH;
+    if constexpr (Rooms >= 2)
+    {
+        constexpr uint64_t EastGaps = (uint64_t)(RoomsW - 1) * (uint64_t)RoomsH;
+        constexpr uint64_t Total = EastGaps + (uint64_t)RoomsW * (uint64_t)(RoomsH - 1);
+        constexpr uint64_t Closed = Total - (Rooms - 1);
+        constexpr uint64_t K = std::min<uint64_t>((uint64_t)std::max(0, BuildOptions{}.extraLoops), Closed);
+
+        auto gapCell = [](uint64_t i) {
+            if (i < EastGaps)
+                return Index((int32_t)(i % (uint64_t)(RoomsW - 1)) * 2 + 2, (int32_t)(i / (uint64_t)(RoomsW - 1)) * 2 + 1);
+            i -= EastGaps;
+            return Index((int32_t)(i % (uint64_t)RoomsW) * 2 + 1, (int32_t)(i / (uint64_t)RoomsW) * 2 + 2);
+        };
+
+        if constexpr (K * 2 <= Closed)
+        {
+            for (uint64_t opened = 0; opened < K;)
+            {
+                const size_t c = gapCell(UniformBelow(rng, Total));
+                if (m.cells[c] == PaddedGrid::Open) continue;
+                m.cells[c] = PaddedGrid::Open;
+                ++opened;
+            }
+        }
+        else
+        {
+            uint64_t left = Closed, need = K;
+            for (uint64_t i = 0; i < Total && need > 0; ++i)
+            {
+                const size_t c = gapCell(i);
+                if (m.cells[c] == PaddedGrid::Open) continue;
+                if (need == left || UniformBelow(rng, left) < need)
+                {
+                    m.cells[c] = PaddedGrid::Open;
+                    --need;
+                }
+                --left;
+            }
+        }
+    }
+    return m;
+}
+
+template <int32_t W, int32_t H>
+StaticMaze<W, H> StaticMaze<W, H>::FromMaze(MazeView maze)
+{
+    if (maze.width != W || maze.height != H)
+        throw std::runtime_error("StaticMaze::FromMaze: size mismatch");
+
+    StaticMaze m{};
+    m.start = maze.start;
+    m.end = maze.end;
+    m.cells.fill(PaddedGrid::Ring);
+    for (int32_t y = 0; y < H; ++y)
+        for (int32_t x = 0; x < W; ++x)
+            m.cells[Index(x, y)] = maze.IsWall(x, y) ? PaddedGrid::Wall : PaddedGrid::Open;
+    return m;
+}
+
+template <int32_t W, int32_t H>
+Maze StaticMaze<W, H>::ToMaze() const
+{
+    Maze maze;
+    maze.seed = seed;
+    maze.start = start;
+    maze.end = end;
+    maze.Resize(W, H, true);
+    for (int32_t y = 0; y < H; ++y)
+        for (int32_t x = 0; x < W; ++x)
+            if (cells[Index(x, y)] == PaddedGrid::Open) maze.walls.Clear(x, y);
+    return maze;
+}
+
+// 四个求解器的定尺寸版本：算法、访问顺序和结果与 PathFinder / WallBreaker / PathCounter / PathPasser 完全相同，
+// 只是查表用常量跨度，开放表 / 记录表 / 队列都是栈上的 std::array，不再经过 PaddedGrid::FromMaze。
+// 查询本身不分配内存，只有写进调用方结果缓冲（visited / path / paths）时才可能扩容。
+// 最大尺寸下单次调用的栈占用约 250KB（A*）/ 320KB（BreakWalls），放在主线程或栈够大的线程里调用
+template <int32_t W, int32_t H>
+class StaticSolver
+{
+    using Grid = StaticMaze<W, H>;
+    static constexpr size_t Size = Grid::Size;
+    static constexpr int dx[4] = { 1, -1, 0, 0 };
+    static constexpr int dy[4] = { 0, 0, 1, -1 };
+
+    using Clock = std::chrono::high_resolution_clock;
+    static std::chrono::milliseconds Since(Clock::time_point t0) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - t0);
+    }
+
+public:
+    // A* + 曼哈顿启发。开放表是定长数组上的二叉堆，比较器与 std::priority_queue 版相同，出堆顺序一致。
+    // 容量：一致启发下每格第一次出堆时 g 已最优，只有这一次展开能改进邻居，且一条相邻边最多单向改进一次，
+    // 所以入堆总数不超过 1 + 相邻通路格对数 + 起点四邻 < 2 * W * H + 8
+    static constexpr size_t HeapCapacity = 2 * (size_t)W * (size_t)H + 8;
+
+    static void pathFinder(const Grid& maze, SearchResult& out)
+    {
+        const auto startTime = Clock::now();
+
+        struct Node {
+            uint16_t idx;
+            int16_t g;
+            int16_t f;
+        };
+        auto cmp = [](const Node& a, const Node& b) { return a.f > b.f; };
+        auto heuristic = [&](Point a) { return std::abs(a.x - maze.end.x) + std::abs(a.y - maze.end.y); };
+
+        std::array<Node, HeapCapacity> heap;
+        size_t heapSize = 0;
+        std::array<int16_t, Size> cost;
+        std::array<uint8_t, Size> cameDir;
+        cost.fill(INT16_MAX);
+
+        auto push = [&](Node n) {
+            heap[heapSize++] = n;
+            std::push_heap(heap.begin(), heap.begin() + (ptrdiff_t)heapSize, cmp);
+        };
+
+        out.Clear();
+        const size_t startIdx = Grid::Index(maze.start.x, maze.start.y);
+        const size_t endIdx = Grid::Index(maze.end.x, maze.end.y);
+        push({ (uint16_t)startIdx, 0, (int16_t)heuristic(maze.start) });
+        cost[startIdx] = 0;
+
+        while (heapSize > 0)
+        {
+            std::pop_heap(heap.begin(), heap.begin() + (ptrdiff_t)heapSize, cmp);
+            const Node current = heap[--heapSize];
+            const Point p = Grid::ToPoint(current.idx);
+            out.visited.push_back(p);
+
+            if (current.idx == endIdx)
+            {
+                for (size_t i = current.idx; i != startIdx; i -= (size_t)Grid::Offsets[cameDir[i]])
+                    out.path.push_back(Grid::ToPoint(i));
+                out.path.push_back(maze.start);
+                std::reverse(out.path.begin(), out.path.end());
+                break;
+            }
+
+            for (int i = 0; i < 4; ++i)
+            {
+                const size_t k = current.idx + (size_t)Grid::Offsets[i];
+                if (maze.cells[k] != PaddedGrid::Open) continue;
+
+                const int newCost = current.g + 1;
+                if (newCost < cost[k])
+                {
+                    cost[k] = (int16_t)newCost;
+                    const Point n{ p.x + dx[i], p.y + dy[i] };
+                    push({ (uint16_t)k, (int16_t)newCost, (int16_t)(newCost + heuristic(n)) });
+                    cameDir[k] = (uint8_t)i;
+                }
+            }
+        }
+
+        out.length = (int32_t)out.path.size();
+        out.expanded = (int32_t)out.visited.size();
+        out.elapsed = Since(startTime);
+    }
+
+    // 分层 BFS：状态 = (格子, 已破墙数)。破墙数是模板参数，状态表按 (Breaks + 1) 层定长；
+    // 状态编号要放进 16 位，即 (Breaks + 1) * Size <= 65536（41x41 时最多破 34 面墙）
+    template <int32_t Breaks>
+    static void BreakWalls(const Grid& maze, SearchResult& out)
+    {
+        static constexpr size_t Keys = (size_t)(Breaks + 1) * Size;
+        static_assert(Breaks >= 0 && Keys <= (1u << 16), "StaticSolver::BreakWalls: too many layers for this size");
+
+        const auto startTime = Clock::now();
+        out.Clear();
+
+        std::array<uint8_t, Keys> seen{};
+        std::array<uint16_t, Keys> parent;
+        std::array<uint16_t, Keys> queue;
+        size_t tail = 0;
+
+        const uint16_t startKey = (uint16_t)Grid::Index(maze.start.x, maze.start.y);
+        const size_t endIdx = Grid::Index(maze.end.x, maze.end.y);
+        queue[tail++] = startKey;
+        seen[startKey] = 1;
+
+        bool found = false;
+        uint16_t endKey = 0;
+        for (size_t head = 0; head < tail; ++head)
+        {
+            const uint16_t key = queue[head];
+            const size_t idx = key % Size;
+            const int broken = (int)(key / Size);
+            out.visited.push_back(Grid::ToPoint(idx));
+
+            if (idx == endIdx)
+            {
+                found = true;
+                endKey = key;
+                break;
+            }
+
+            for (int i = 0; i < 4; ++i)
+            {
+                const size_t n = idx + (size_t)Grid::Offsets[i];
+                const uint8_t c = maze.cells[n];
+                if (c == PaddedGrid::Ring) continue;
+
+                const int nb = broken + c;
+                if (nb > Breaks) continue;
+
+                const uint16_t nk = (uint16_t)((size_t)nb * Size + n);
+                if (seen[nk]) continue;
+
+                seen[nk] = 1;
+                parent[nk] = key;
+                queue[tail++] = nk;
+            }
+        }
+
+        if (found)
+        {
+            for (uint16_t k = endKey; k != startKey; k = parent[k])
+                out.path.push_back(Grid::ToPoint(k % Size));
+            out.path.push_back(maze.start);
+            std::reverse(out.path.begin(), out.path.end());
+        }
+
+        out.length = (int32_t)out.path.size();
+        out.expanded = (int32_t)out.visited.size();
+        out.elapsed = Since(startTime);
+    }
+
+    // 回溯枚举全部简单路径
+    static void CountPaths(const Grid& maze, Point start, Point end, CountResult& out)
+    {
+        const auto startTime = Clock::now();
+        out.Clear();
+
+        if (start == end)
+        {
+            out.paths.push_back({ start });
+            out.lengths.push_back(1);
+            out.ways = 1;
+            return;
+        }
+
+        // 当前路径是栈上的定长数组（简单路径不超过格数），只有找到一条时才拷进结果
+        std::array<uint8_t, Size> blocked = maze.cells;
+        std::array<Point, Size> current;
+        size_t depth = 0;
+
+        auto dfs = [&](auto& self, Point p, size_t idx) -> void {
+            current[depth++] = p;
+            const uint8_t saved = blocked[idx];
+            blocked[idx] = PaddedGrid::Wall;
+
+            if (p == end)
+            {
+                out.paths.emplace_back(current.begin(), current.begin() + (ptrdiff_t)depth);
+                out.lengths.push_back((int32_t)depth);
+            }
+            else
+            {
+                for (int i = 0; i < 4; ++i)
+                {
+                    const size_t n = idx + (size_t)Grid::Offsets[i];
+                    if (blocked[n]) continue;
+                    self(self, { p.x + dx[i], p.y + dy[i] }, n);
+                }
+            }
+
+            blocked[idx] = saved;
+            --depth;
+        };
+        dfs(dfs, start, Grid::Index(start.x, start.y));
+
+        out.ways = (int32_t)out.paths.size();
+        out.elapsed = Since(startTime);
+    }
+
+    // 起点 -> (x, y) -> 终点，两段各用双向 BFS
+    static void PassPath(const Grid& maze, uint32_t x, uint32_t y, PassResult& out)
+    {
+        const auto startTime = Clock::now();
+        out.Clear();
+
+        const Point mid{ (int32_t)x, (int32_t)y };
+        if (maze.IsWall(mid.x, mid.y)) return;
+
+        // 找到时把 start..end 的路径追加到 out.path；不经过临时 vector
+        auto biBFS = [&](Point start, Point end, std::vector<Point>& visitedOut) -> bool {
+            if (start == end)
+            {
+                visitedOut.push_back(start);
+                out.path.push_back(start);
+                return true;
+            }
+
+            std::array<uint16_t, Size> q1, q2, prev1, prev2;
+            std::array<uint8_t, Size> vis1{}, vis2{};
+            size_t h1 = 0, t1 = 0, h2 = 0, t2 = 0;
+
+            const size_t s = Grid::Index(start.x, start.y);
+            const size_t e = Grid::Index(end.x, end.y);
+            q1[t1++] = (uint16_t)s;
+            q2[t2++] = (uint16_t)e;
+            vis1[s] = 1;
+            vis2[e] = 1;
+
+            // 一侧扩展一层，碰到另一侧访问过的格子返回相遇点
+            auto expand = [&](std::array<uint16_t, Size>& q, size_t& head, size_t& tail, std::array<uint8_t, Size>& vis,
+                              std::array<uint16_t, Size>& prev, const std::array<uint8_t, Size>& other) -> size_t {
+                for (size_t level = tail - head; level > 0; --level)
+                {
+                    const size_t cur = q[head++];
+                    visitedOut.push_back(Grid::ToPoint(cur));
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        const size_t k = cur + (size_t)Grid::Offsets[i];
+                        if (maze.cells[k] != PaddedGrid::Open || vis[k]) continue;
+
+                        vis[k] = 1;
+                        prev[k] = (uint16_t)cur;
+                        if (other[k]) return k;
+                        q[tail++] = (uint16_t)k;
+                    }
+                }
+                return SIZE_MAX;
+            };
+
+            size_t meet = SIZE_MAX;
+            while (h1 != t1 && h2 != t2)
+            {
+                if ((meet = expand(q1, h1, t1, vis1, prev1, vis2)) != SIZE_MAX) break;
+                if ((meet = expand(q2, h2, t2, vis2, prev2, vis1)) != SIZE_MAX) break;
+            }
+            if (meet == SIZE_MAX) return false;
+
+            const size_t mark = out.path.size();
+            for (size_t c = meet; c != s; c = prev1[c])
+                out.path.push_back(Grid::ToPoint(c));
+            out.path.push_back(start);
+            std::reverse(out.path.begin() + (ptrdiff_t)mark, out.path.end());
+            for (size_t c = meet; c != e;)
+            {
+                c = prev2[c];
+                out.path.push_back(Grid::ToPoint(c));
+            }
+            return true;
+        };
+
+        if (mid == maze.start || mid == maze.end)
+        {
+            biBFS(maze.start, maze.end, out.visitedToMid);
+            out.length = (int32_t)out.path.size();
+            out.elapsed = Since(startTime);
+            return;
+        }
+
+        // 两段都要跑（访问记录与动态版一致）；第一段的终点就是第二段的起点，接上前去掉一份
+        const bool first = biBFS(maze.start, mid, out.visitedToMid);
+        if (first) out.path.pop_back();
+        const bool second = biBFS(mid, maze.end, out.visitedFromMid);
+        if (!first || !second)
+        {
+            out.path.clear();
+            return;
+        }
+
+        out.length = (int32_t)out.path.size();
+        out.elapsed = Since(startTime);
+    }
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include "core/Common.hpp"
+#include "core/Random.hpp"
+
+// 整字生成 Binary Tree / Sidewinder：一个房间行只取决于本行的随机位，
+// 64 个房间一组用按位运算得到“向北 / 向东”掩码，再隔位展开成网格行的 64 位字（32 个房间一字）。
+// 随机位来自 4 路并行的 xoshiro256**：AVX2 一条指令推进 4 路，其他平台走标量路径，两条路径输出逐位相同
+class WordRows
+{
+public:
+    enum class Kind : uint8_t { BinaryTree, Sidewinder };
+
+    // 随机流只从 rng 取种子；avx2 只影响速度
+    WordRows(Kind kind, int32_t roomsW, Xoshiro256& rng, bool avx2 = HasAvx2());
+
+    static bool HasAvx2();
+
+    // 生成下一房间行（从 ry = 0 开始）
+    void Next();
+
+    // 当前房间行：bit i = 房间 i 向北 / 向东打通，每字 64 个房间
+    std::span<const uint64_t> North() const { return north; }
+    std::span<const uint64_t> East() const  { return east; }
+
+    // 网格行的字数 (2 * roomsW + 1 + 63) / 64
+    size_t RowWords() const { return rowWords; }
+
+    // 展开当前房间行：gapRow 为网格行 2ry（北墙缝），roomRow 为网格行 2ry+1；1=墙，超出行宽的位为 1
+    void Expand(std::span<uint64_t> gapRow, std::span<uint64_t> roomRow) const;
+
+    // 任意房间行掩码的展开（Eller 流式生成也用）：valid 为存在的房间，west 为向西打通的房间，
+    // gaps 为开在 gapRow 里的墙缝；三者至少 RoomWords(roomsW) 字（按 4 个网格字一组整读，多出的字为 0）
+    static size_t RoomWords(int32_t roomsW);
+    static void ExpandRow(std::span<const uint64_t> valid, std::span<const uint64_t> west, std::span<const uint64_t> gaps,
+                          std::span<uint64_t> gapRow, std::span<uint64_t> roomRow, bool avx2 = HasAvx2());
+
+private:
+    void FillCoins();
+
+    Kind kind;
+    int32_t roomsW;
+    int32_t ry = 0;
+    bool avx2;
+    size_t rowWords;
+
+    alignas(32) std::array<uint64_t, 16> lanes{};   // 4 路状态：lanes[k * 4 + 路号] 为第 k 个状态字
+    Xoshiro256 pick;                                 // Sidewinder 每段选北口
+
+    std::vector<uint64_t> coins, valid, north, east, west;
+};
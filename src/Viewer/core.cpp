@@ -1,6 +1,7 @@
 #include "Viewer/core.hpp"
 #include "Viewer/ViewerInternal.hpp"
 #include "core/MazeBuilder.hpp"
+#include "core/MazeFile.hpp"
 #include "core/PathFinder.hpp"
 
 #include <algorithm>
@@ -22,12 +23,12 @@ Viewer::~Viewer()
     shutdownGL(); 
 }
 
-// 更新路径动画（根据动画模式刷新迷宫显示）
+// 更新路径动画（根据动画模式刷新覆盖层，墙体层不动）
 void Viewer::pathAnim()
 {
     if (!anim.active) return;
     if (!mazeLoaded) { anim.active = false; return; }
-    if (maze.grid.empty() || maze.grid[0].empty()) { anim.active = false; return; }
+    if (maze.Empty() || overlay.size() != maze.CellCount()) { anim.active = false; return; }
 
     constexpr auto TOTAL = std::chrono::milliseconds(3000);
 
@@ -36,9 +37,8 @@ void Viewer::pathAnim()
     if (elapsed < std::chrono::milliseconds(0)) elapsed = std::chrono::milliseconds(0);
     if (elapsed > TOTAL) elapsed = TOTAL;
 
-    const int H = (int)maze.grid.size();
-    const int W = (int)maze.grid[0].size();
-    const size_t N = (size_t)W * (size_t)H;
+    const size_t N = maze.CellCount();
+    auto ov = overlayGrid();
 
     // MODE 1: COUNT overlay animation
     if (anim.mode == 1)
@@ -79,16 +79,17 @@ void Viewer::pathAnim()
             {
                 const auto& p = one[j];
                 if (!maze.InBounds(p.x, p.y)) continue;
-                if (maze.grid[p.y][p.x] == 1) continue;
 
-                const size_t idx = (size_t)p.y * (size_t)W + (size_t)p.x;
+                const size_t idx = maze.Index(p.x, p.y);
+                if (maze.IsWallAt(idx)) continue;
+
                 const int32_t cnt = ++anim.passCount[idx];
 
                 float a = (float)cnt / (float)anim.totalPaths;
                 if (a > 1.0f) a = 1.0f;
 
                 cellAlphaOverride[idx] = a;
-                maze.grid[p.y][p.x] = 6;
+                ov[p.y, p.x] = 6;
             }
 
             lastLen = targetLen;
@@ -132,53 +133,37 @@ void Viewer::pathAnim()
     if (nVisited == anim.lastVisitedN && nPath == anim.lastPathN && elapsed != TOTAL)
         return;
 
+    // 时间单调递增：只画新增的点，不再整图清空重画
+    const size_t fromVisited = (anim.lastVisitedN == (size_t)-1) ? 0 : std::min(anim.lastVisitedN, nVisited);
+    const size_t fromPath    = (anim.lastPathN == (size_t)-1) ? 0 : std::min(anim.lastPathN, nPath);
+
     anim.lastVisitedN = nVisited;
     anim.lastPathN = nPath;
 
-    // clear non-walls
-    for (int y = 0; y < H; ++y)
-        for (int x = 0; x < W; ++x)
-            if (maze.grid[y][x] != 1) maze.grid[y][x] = 0;
-
     // paint visited
-    for (size_t i = 0; i < nVisited; ++i)
+    for (size_t i = fromVisited; i < nVisited; ++i)
     {
         const auto& p = anim.visited[i];
-        if (!maze.InBounds(p.x, p.y)) continue;
-        if (maze.grid[p.y][p.x] == 1) continue;
+        if (maze.IsWall(p.x, p.y)) continue;
 
-        maze.grid[p.y][p.x] = anim.visitedVal;
+        ov[p.y, p.x] = (uint8_t)anim.visitedVal;
     }
 
     // paint path
-    for (size_t i = 0; i < nPath; ++i)
+    for (size_t i = fromPath; i < nPath; ++i)
     {
         const auto& p = anim.path[i];
         if (!maze.InBounds(p.x, p.y)) continue;
 
-        const size_t idx = (size_t)p.y * (size_t)W + (size_t)p.x;
-
-        
-        if (maze.grid[p.y][p.x] == 1)
+        // BREAK: path cell on a wall => render as "broken" marker
+        if (maze.IsWallAt(maze.Index(p.x, p.y)))
         {
-            if (anim.pathVal == 7 && anim.hasOrigWall && anim.origWall.size() == N && anim.origWall[idx] == 1)
-            {
-                maze.grid[p.y][p.x] = 18;
-            }
+            if (anim.pathVal == 7)
+                ov[p.y, p.x] = 18;
             continue;
         }
 
-        // BREAK: if this path cell was a wall in the ORIGINAL maze => render as "broken" marker
-        if (anim.pathVal == 7 && anim.hasOrigWall && anim.origWall.size() == N)
-        {
-            if (anim.origWall[idx] == 1)
-            {
-                maze.grid[p.y][p.x] = 18;
-                continue;
-            }
-        }
-
-        maze.grid[p.y][p.x] = anim.pathVal;
+        ov[p.y, p.x] = (uint8_t)anim.pathVal;
     }
 
     mazeDirty = true;
@@ -188,7 +173,7 @@ void Viewer::pathAnim()
 }
 
 // 主循环，初始化窗口和 OpenGL，渲染迷宫和 UI
-void Viewer::run()
+void Viewer::run(const std::string& mazePath)
 {
     initWindowAndGL();
 
@@ -201,8 +186,11 @@ void Viewer::run()
         glViewport(0, 0, fbW, fbH);
     }
 
-    // 初始生成一个迷宫，避免空白
-    buildMaze(uiSeed);
+    // 初始载入/生成一个迷宫，避免空白
+    if (!mazePath.empty())
+        loadMaze(mazePath);
+    else
+        buildMaze(uiSeed);
 
     auto* win = static_cast<GLFWwindow*>(window);
     while (win && !glfwWindowShouldClose(win))
@@ -228,7 +216,11 @@ void Viewer::updateWindowTitle()
 {
     if (!window) return;
 
-    std::string title = "Maze Viewer  |  seed=" + std::to_string(uiSeed);
+    std::string title = "Maze Viewer  |  seed=" + std::to_string(uiSeed)
+                      + "  |  " + std::to_string(maze.width) + "x" + std::to_string(maze.height)
+                      + "  |  " + MazeBuilder::GeneratorName(uiGenerator);
+    if (maze.buildTime.count() > 0)
+        title += " " + std::to_string(maze.buildTime.count()) + " us";
     glfwSetWindowTitle(static_cast<GLFWwindow*>(window), title.c_str());
 }
 
@@ -237,32 +229,88 @@ void Viewer::buildMaze(int seed)
 {
     uiSeed = seed;
 
-    Maze m = MazeBuilder::Build(seed);
-
-    m.height = (int)m.grid.size();
-    m.width  = (m.height > 0) ? (int)m.grid[0].size() : 0;
+    BuildOptions options;
+    options.generator = uiGenerator;
+    Maze m = MazeBuilder::Build(seed, uiMazeW, uiMazeH, options);
 
     m.start = {1, 1};
     m.end   = {std::max(1, m.width - 2), std::max(1, m.height - 2)};
 
+    setMaze(std::move(m));
+}
+
+// 打开迷宫文件（mmap），并同步 UI 起终点；打不开或超出 ViewerMaxSide 时报错并改为按当前种子生成
+void Viewer::loadMaze(const std::string& path)
+{
+    Maze m;
+    try
+    {
+        m = MazeFile::Open(path);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << "; building seed " << uiSeed << " instead\n";
+        buildMaze(uiSeed);
+        return;
+    }
+
+    // 渲染要读遍所有格子、覆盖层按格分配：太大的迷宫既画不动也会把整个映射换入内存
+    if (m.width > ViewerMaxSide || m.height > ViewerMaxSide)
+    {
+        std::cerr << path << ": " << m.width << "x" << m.height << " exceeds the viewer limit of "
+                  << ViewerMaxSide << "x" << ViewerMaxSide << "; building seed " << uiSeed << " instead\n";
+        buildMaze(uiSeed);
+        return;
+    }
+
+    uiSeed = m.seed;
+
+    // 只预读起终点附近的条带，其余按需换入
+    MazeFile::Prefetch(m, m.start.y - 1, m.start.y + 2);
+    MazeFile::Prefetch(m, m.end.y - 1, m.end.y + 2);
+
+    setMaze(std::move(m));
+}
+
+// 替换当前迷宫，重置覆盖层和动画
+void Viewer::setMaze(Maze&& m)
+{
     maze = std::move(m);
     mazeLoaded = true;
     mazeDirty = true;
 
+    anim.active = false;
+    alphaOverrideActive = false;
+    cellAlphaOverride.clear();
+    overlay.assign(maze.CellCount(), 0);
+
+    // 求解器的哨兵网格只在换迷宫时拷一次；之后起终点被打通时就地改这几格
+    searchCtx.Bind(maze);
+
     // 同步 UI 的起终点
     uiStartX = maze.start.x; uiStartY = maze.start.y;
     uiEndX   = maze.end.x;   uiEndY   = maze.end.y;
-
-    const int H = (int)maze.grid.size();
-    const int W = (H > 0) ? (int)maze.grid[0].size() : 0;
-    baseWall.assign((size_t)W * (size_t)H, 0);
-    for (int y = 0; y < H; ++y)
-        for (int x = 0; x < W; ++x)
-            baseWall[(size_t)y * (size_t)W + (size_t)x] = (maze.grid[y][x] == 1) ? 1 : 0;
+    uiMazeW  = std::min(maze.width, ViewerMaxSide);
+    uiMazeH  = std::min(maze.height, ViewerMaxSide);
+    uiGenerator = maze.generator;
 
     updateWindowTitle();
 }
 
+// 覆盖层视图（按迷宫尺寸）
+OverlayView Viewer::overlayGrid()
+{
+    return OverlayView(overlay.data(), (size_t)maze.height, (size_t)maze.width);
+}
+
+// 清空覆盖层，开始新一轮动画
+void Viewer::clearOverlay()
+{
+    overlay.assign(maze.CellCount(), 0);
+    alphaOverrideActive = false;
+    cellAlphaOverride.clear();
+}
+
 // 寻找路径或计数路径，根据算法类型更新动画和迷宫状态
 void Viewer::findPath(int sx, int sy, int ex, int ey, int algoIndex)
 {
@@ -270,25 +318,10 @@ void Viewer::findPath(int sx, int sy, int ex, int ey, int algoIndex)
 
     uiAlgoIndex = algoIndex;
 
-    const int H = (int)maze.grid.size();
-    const int W = (H > 0) ? (int)maze.grid[0].size() : 0;
+    const int H = maze.height;
+    const int W = maze.width;
     if (W <= 0 || H <= 0) return;
 
-    const size_t N = (size_t)W * (size_t)H;
-    if (baseWall.size() == N)
-    {
-        for (int y = 0; y < H; ++y)
-            for (int x = 0; x < W; ++x)
-                maze.grid[y][x] = baseWall[(size_t)y * (size_t)W + (size_t)x] ? 1 : 0;
-    }
-    else
-    {
-        // fallback
-        for (int y = 0; y < H; ++y)
-            for (int x = 0; x < W; ++x)
-                if (maze.grid[y][x] != 1) maze.grid[y][x] = 0;
-    }
-
     sx = std::clamp(sx, 0, W - 1);
     sy = std::clamp(sy, 0, H - 1);
     ex = std::clamp(ex, 0, W - 1);
@@ -296,85 +329,54 @@ void Viewer::findPath(int sx, int sy, int ex, int ey, int algoIndex)
 
     maze.start = {sx, sy};
     maze.end   = {ex, ey};
-    maze.width = W;
-    maze.height = H;
 
-    if (maze.InBounds(sx, sy)) maze.grid[sy][sx] = 0;
-    if (maze.InBounds(ex, ey)) maze.grid[ey][ex] = 0;
+    // 起终点保证可走（唯一一次修改墙体层），已 Bind 的网格同步改这两格
+    maze.SetWall(sx, sy, false);
+    maze.SetWall(ex, ey, false);
+    searchCtx.SetWall(maze.start, false);
+    searchCtx.SetWall(maze.end, false);
 
-    if (baseWall.size() == N)
-    {
-        baseWall[(size_t)sy * (size_t)W + (size_t)sx] = 0;
-        baseWall[(size_t)ey * (size_t)W + (size_t)ex] = 0;
-    }
-
-    alphaOverrideActive = false;
-    cellAlphaOverride.clear();
+    clearOverlay();
 
     // COUNT
     if (algoIndex == 2)
     {
-        auto result = PathCounter::CountPaths(maze, maze.start, maze.end);
-        auto allPaths = std::move(std::get<0>(result).first);
-        const int32_t ways = std::get<1>(result);
+        PathCounter::CountPaths(searchCtx, maze.start, maze.end, countBuf);
+        const int32_t ways = countBuf.ways;
 
         lastCountWays = (int)std::max<int32_t>(0, ways);
 
-        for (int y = 0; y < H; ++y)
-            for (int x = 0; x < W; ++x)
-                if (maze.grid[y][x] != 1) maze.grid[y][x] = 0;
-
         anim.active = true;
         anim.mode = 1;
         anim.t0 = std::chrono::steady_clock::now();
-        anim.allPaths = std::move(allPaths);
+        anim.allPaths.swap(countBuf.paths);
         anim.totalPaths = std::max<int>(0, ways);
 
         anim.lastLenPerPath.assign(anim.allPaths.size(), 0);
 
         anim.passCount.clear();
 
-        anim.hasOrigWall = false;
-        anim.origWall.clear();
-
         mazeDirty = true;
         updateWindowTitle();
         return;
     }
 
-    // PATH / BREAK
-    std::vector<Point> path;
-    std::vector<Point> visited;
-
-    anim.hasOrigWall = false;
-    anim.origWall.clear();
-
+    // PATH / BREAK：结果写进复用缓冲，再与动画交换（上一轮动画的容量留给下一次）
     if (algoIndex == 1)
     {
-        // snapshot original walls BEFORE running breaker
-        anim.hasOrigWall = true;
-        anim.origWall.resize((size_t)W * (size_t)H, 0);
-        for (int y = 0; y < H; ++y)
-            for (int x = 0; x < W; ++x)
-                anim.origWall[(size_t)y * (size_t)W + (size_t)x] = (maze.grid[y][x] == 1) ? 1 : 0;
-
         const int bc = std::clamp(uiBreakCount, 0, 9);
-        auto result = WallBreaker::BreakWalls(maze, bc);
-        path = std::get<0>(result);
-        visited = std::get<1>(result);
+        WallBreaker::BreakWalls(searchCtx, maze.start, maze.end, bc, searchBuf);
 
-        lastBreakLen = (int)path.size();
+        lastBreakLen = searchBuf.length;
 
         anim.pathVal = 7;
         anim.visitedVal = 17;
     }
     else
     {
-        auto result = PathFinder::pathFinder(maze);
-        path = std::get<0>(result);
-        visited = std::get<1>(result);
+        PathFinder::pathFinder(searchCtx, maze.start, maze.end, searchBuf);
 
-        lastPathLen = (int)path.size();    // +++ add
+        lastPathLen = searchBuf.length;    // +++ add
 
         anim.pathVal = 5;
         anim.visitedVal = 15;
@@ -383,15 +385,11 @@ void Viewer::findPath(int sx, int sy, int ex, int ey, int algoIndex)
     anim.active = true;
     anim.mode = 0;
     anim.t0 = std::chrono::steady_clock::now();
-    anim.visited = std::move(visited);
-    anim.path = std::move(path);
+    anim.visited.swap(searchBuf.visited);
+    anim.path.swap(searchBuf.path);
     anim.lastVisitedN = (size_t)-1;
     anim.lastPathN = (size_t)-1;
 
-    for (int y = 0; y < H; ++y)
-        for (int x = 0; x < W; ++x)
-            if (maze.grid[y][x] != 1) maze.grid[y][x] = 0;
-
     mazeDirty = true;
     updateWindowTitle();
 }
@@ -409,18 +407,10 @@ void Viewer::passPath(int32_t x, int32_t y)
 {
     if (!mazeLoaded) return;
 
-    const int H = (int)maze.grid.size();
-    const int W = (H > 0) ? (int)maze.grid[0].size() : 0;
+    const int H = maze.height;
+    const int W = maze.width;
     if (W <= 0 || H <= 0) return;
 
-    const size_t N = (size_t)W * (size_t)H;
-
-    if (baseWall.size() == N) {
-        for (int yy = 0; yy < H; ++yy)
-            for (int xx = 0; xx < W; ++xx)
-                maze.grid[yy][xx] = baseWall[(size_t)yy * (size_t)W + (size_t)xx] ? 1 : 0;
-    }
-
     const int sx = 1;
     const int sy = 1;
     const int ex = std::max(1, W - 2);
@@ -428,45 +418,30 @@ void Viewer::passPath(int32_t x, int32_t y)
 
     maze.start = { sx, sy };
     maze.end   = { ex, ey };
-    maze.width = W;
-    maze.height = H;
 
     // keep endpoints walkable
-    if (maze.InBounds(sx, sy)) maze.grid[sy][sx] = 0;
-    if (maze.InBounds(ex, ey)) maze.grid[ey][ex] = 0;
-
-    // keep baseWall consistent with carved endpoints
-    if (baseWall.size() == N)
-    {
-        baseWall[(size_t)sy * (size_t)W + (size_t)sx] = 0;
-        baseWall[(size_t)ey * (size_t)W + (size_t)ex] = 0;
-    }
+    if (maze.InBounds(sx, sy)) { maze.SetWall(sx, sy, false); searchCtx.SetWall(maze.start, false); }
+    if (maze.InBounds(ex, ey)) { maze.SetWall(ex, ey, false); searchCtx.SetWall(maze.end, false); }
 
     // clamp mid
     const int32_t mx = std::clamp<int32_t>((int32_t)x, 0, W - 1);
     const int32_t my = std::clamp<int32_t>((int32_t)y, 0, H - 1);
 
-    alphaOverrideActive = false;
-    cellAlphaOverride.clear();
+    clearOverlay();
 
-    auto result = PathPasser::PassPath(maze, (uint32_t)mx, (uint32_t)my);
+    PathPasser::PassPath(searchCtx, maze.start, maze.end, { mx, my }, passBuf);
 
-    auto path     = std::move(std::get<0>(result));
-    auto visited1 = std::move(std::get<1>(result));
-    auto visited2 = std::move(std::get<2>(result));
-
-    visited1.insert(visited1.end(), visited2.begin(), visited2.end());
-
-    anim.hasOrigWall = false;
-    anim.origWall.clear();
+    // 两段访问记录接在一起播放
+    passBuf.visitedToMid.insert(passBuf.visitedToMid.end(),
+                                passBuf.visitedFromMid.begin(), passBuf.visitedFromMid.end());
 
     anim.active = true;
     anim.mode = 0;
     anim.t0 = std::chrono::steady_clock::now();
-    anim.visited = std::move(visited1);
-    anim.path = std::move(path);
+    anim.visited.swap(passBuf.visitedToMid);
+    anim.path.swap(passBuf.path);
 
-    lastPassLen = (int)anim.path.size();
+    lastPassLen = passBuf.length;
 
     // PASS color tiles (match PASS button)
     anim.visitedVal = 19;
@@ -475,23 +450,6 @@ void Viewer::passPath(int32_t x, int32_t y)
     anim.lastVisitedN = (size_t)-1;
     anim.lastPathN = (size_t)-1;
 
-    // clear for animation base using baseWall (prevents wall corruption)
-    if (baseWall.size() == N)
-    {
-        for (int yy = 0; yy < H; ++yy)
-            for (int xx = 0; xx < W; ++xx)
-                maze.grid[yy][xx] = baseWall[(size_t)yy * (size_t)W + (size_t)xx] ? 1 : 0;
-
-        maze.grid[sy][sx] = 0;
-        maze.grid[ey][ex] = 0;
-    }
-    else
-    {
-        for (int yy = 0; yy < H; ++yy)
-            for (int xx = 0; xx < W; ++xx)
-                if (maze.grid[yy][xx] != 1) maze.grid[yy][xx] = 0;
-    }
-
     mazeDirty = true;
     updateWindowTitle();
 }
@@ -32,6 +32,15 @@ void Viewer::applyEdit()
     case UI::EndY:        parseInt(uiEndY);        break;
     case UI::UpdateEvery: parseInt(uiUpdateEvery); break;
     case UI::DelayMs:     parseInt(uiDelayMs);     break;
+
+    case UI::MazeW:
+        parseInt(uiMazeW);
+        uiMazeW = std::min(MazeBuilder::NormalizeSide(uiMazeW), ViewerMaxSide);
+        break;
+    case UI::MazeH:
+        parseInt(uiMazeH);
+        uiMazeH = std::min(MazeBuilder::NormalizeSide(uiMazeH), ViewerMaxSide);
+        break;
     default: break;
     }
 }
@@ -76,8 +85,8 @@ void Viewer::initUiCallbacks()
 
         if (ch == '-')
         {
-            // BreakCount 不允许负数
-            if (self->uiFocus == UI::BreakCount) return;
+            // BreakCount / 尺寸不允许负数
+            if (self->uiFocus == UI::BreakCount || self->uiFocus == UI::MazeW || self->uiFocus == UI::MazeH) return;
 
             if (self->uiEdit.empty()) self->uiEdit.push_back(ch);
             return;
@@ -115,6 +124,12 @@ void Viewer::initUiCallbacks()
             self->buildMaze(self->uiSeed);
             return;
         }
+        if (key == GLFW_KEY_G) {
+            // 切换生成算法并用当前种子重新生成
+            self->uiGenerator = (MazeGenerator)(((int)self->uiGenerator + 1) % MazeBuilder::GeneratorCount);
+            self->buildMaze(self->uiSeed);
+            return;
+        }
         if (key == GLFW_KEY_F) {
     self->findPath(self->uiStartX, self->uiStartY, self->uiEndX, self->uiEndY, self->uiAlgoIndex);
     return;
@@ -233,23 +248,63 @@ void Viewer::initUiCallbacks()
             self->updateWindowTitle();
             return;
         }
+
+        // W/H size boxes below the result box (match ui.cpp)
+        const float sizeLabelY1 = (xyY0 - gap - 0.11f) - gap;
+        const float sizeLabelY0 = sizeLabelY1 - seedLabelH;
+
+        const float sizeY1 = sizeLabelY0 - 0.012f;
+        const float sizeY0 = sizeY1 - xyH;
+
+        if (Hit(mx, my, xBoxX0, sizeY0, xBoxX1, sizeY1))
+        {
+            self->uiFocus = UI::MazeW;
+            self->uiEdit = std::to_string(self->uiMazeW);
+            self->updateWindowTitle();
+            return;
+        }
+
+        if (Hit(mx, my, yBoxX0, sizeY0, yBoxX1, sizeY1))
+        {
+            self->uiFocus = UI::MazeH;
+            self->uiEdit = std::to_string(self->uiMazeH);
+            self->updateWindowTitle();
+            return;
+        }
         
         const float btnH = 0.11f;
         const float btnGap = 0.018f;
         const float bottomY0 = panelY0 + padY;
 
-        // Row 0: PATH
+        // Row 0: PATH + [search mode box]
         {
             const float y0 = bottomY0 + 0 * (btnH + btnGap);
             const float y1 = y0 + btnH;
-            if (Hit(mx, my, contentX0, y0, contentX1, y1))
+
+            const float boxW = btnH;
+            const float boxGap = 0.012f;
+            const float boxX0 = contentX1 - boxW;
+            const float boxX1 = contentX1;
+            const float btnX0 = contentX0;
+            const float btnX1 = boxX0 - boxGap;
+
+            // click on mode box: cycle A* -> JPS -> bidirectional
+            if (Hit(mx, my, boxX0, y0, boxX1, y1))
+            {
+                self->uiFocus = UI::None;
+                self->uiEdit.clear();
+                self->searchCtx.mode = (SearchMode)(((int)self->searchCtx.mode + 1) % SearchModeCount);
+                return;
+            }
+
+            if (Hit(mx, my, btnX0, y0, btnX1, y1))
             {
                 self->uiFocus = UI::None;
                 self->uiEdit.clear();
 
-                int W = 71, H = 71;
-                if (self->mazeLoaded && !self->maze.grid.empty() && !self->maze.grid[0].empty())
-                { H = (int)self->maze.grid.size(); W = (int)self->maze.grid[0].size(); }
+                int W = self->uiMazeW, H = self->uiMazeH;
+                if (self->mazeLoaded && !self->maze.Empty())
+                { H = self->maze.height; W = self->maze.width; }
 
                 self->findPath(1, 1, std::max(1, W - 2), std::max(1, H - 2), 0);
                 return;
@@ -283,9 +338,9 @@ void Viewer::initUiCallbacks()
                 self->uiFocus = UI::None;
                 self->uiEdit.clear();
 
-                int W = 71, H = 71;
-                if (self->mazeLoaded && !self->maze.grid.empty() && !self->maze.grid[0].empty())
-                { H = (int)self->maze.grid.size(); W = (int)self->maze.grid[0].size(); }
+                int W = self->uiMazeW, H = self->uiMazeH;
+                if (self->mazeLoaded && !self->maze.Empty())
+                { H = self->maze.height; W = self->maze.width; }
 
                 self->findPath(1, 1, std::max(1, W - 2), std::max(1, H - 2), 1);
                 return;
@@ -302,9 +357,9 @@ void Viewer::initUiCallbacks()
                 self->uiFocus = UI::None;
                 self->uiEdit.clear();
 
-                int W = 71, H = 71;
-                if (self->mazeLoaded && !self->maze.grid.empty() && !self->maze.grid[0].empty())
-                { H = (int)self->maze.grid.size(); W = (int)self->maze.grid[0].size(); }
+                int W = self->uiMazeW, H = self->uiMazeH;
+                if (self->mazeLoaded && !self->maze.Empty())
+                { H = self->maze.height; W = self->maze.width; }
 
                 self->findPath(1, 1, std::max(1, W - 2), std::max(1, H - 2), 2);
                 return;
@@ -17,21 +17,28 @@ void Viewer::rebuildMesh()
 }
 
 // 根据迷宫数据生成顶点数组，并上传到 OpenGL 缓冲区
+// 按块出网格：一块 step x step 个格子，每边块数不超过迷宫区域的像素边长和 MeshMaxBlocks
+// （格子比像素小时多出的细节本来也看不见）；同一行里颜色相同的相邻块并成一个矩形。
+// 顶点数只随窗口大小变，不随迷宫尺寸变；重建仍要读一遍所有格子
 void Viewer::rebuildMeshFromMaze(const Maze& m)
 {
-    const auto& grid = m.grid;
-    const int rows = (int)grid.size();
+    const int rows = m.height;
     if (rows <= 0) { vertexCount = 0; return; }
-    const int cols = (int)grid[0].size();
+    const int cols = m.width;
     if (cols <= 0) { vertexCount = 0; return; }
+    if (overlay.size() != m.CellCount()) { vertexCount = 0; return; }
+
+    const int sidePx = std::clamp(std::min(fbW, fbH), 1, MeshMaxBlocks);
+    const int step = std::max(1, (std::max(rows, cols) + sidePx - 1) / sidePx);
+    const int blockRows = (rows + step - 1) / step;
+    const int blockCols = (cols + step - 1) / step;
 
     std::vector<Vertex> verts;
-    verts.reserve((size_t)rows * (size_t)cols * 6);
 
-    // 单元格大小和起始坐标
-    const float cell = 2.0f / (float)std::max(rows, cols);
-    const float totalW = cell * (float)cols;
-    const float totalH = cell * (float)rows;
+    // 块大小和起始坐标
+    const float cell = 2.0f / (float)std::max(blockRows, blockCols);
+    const float totalW = cell * (float)blockCols;
+    const float totalH = cell * (float)blockRows;
     const float startX = -1.0f + (2.0f - totalW) * 0.5f;
     const float startY =  1.0f - (2.0f - totalH) * 0.5f;
 
@@ -47,32 +54,69 @@ void Viewer::rebuildMeshFromMaze(const Maze& m)
     const float visitedA = 0.50f;
     const float opaqueA  = 1.00f;
 
+    // 墙体层 + 覆盖层合成出一格的显示码
+    auto shade = [&](size_t idx) -> uint8_t {
+        const uint8_t ov = overlay[idx];
+        return (m.IsWallAt(idx) && ov != 18) ? 1 : ov;
+    };
+    // 一块多格时：路径类标记优先于访问类标记，都没有就按墙占的比例（量化到 1/8）在通路色和墙色之间取灰
+    auto markRank = [](uint8_t v) { return (v == 0 || v == 1) ? 0 : (v < 15 || v == 18) ? 2 : 1; };
+
+    // 同色相邻块合并：run 记着当前行里还没输出的一段
+    struct Run { int c0 = -1, c1 = -1; float r = 0, g = 0, b = 0, a = 0; } run;
+    float runY0 = 0.0f, runY1 = 0.0f;
+    auto flush = [&] {
+        if (run.c0 < 0) return;
+        PushRect(verts, startX + (float)run.c0 * cell, runY0, startX + (float)run.c1 * cell, runY1, run.r, run.g, run.b, run.a);
+        run.c0 = -1;
+    };
+
     // 绘制迷宫网格
-    for (int r = 0; r < rows; ++r)
+    for (int br = 0; br < blockRows; ++br)
     {
-        for (int c = 0; c < cols; ++c)
+        const float y0 = startY - (float)(br + 1) * cell;
+        const float y1 = y0 + cell;
+        runY0 = y0;
+        runY1 = y1;
+
+        for (int bc = 0; bc < blockCols; ++bc)
         {
-            const float x0 = startX + (float)c * cell;
-            const float y0 = startY - (float)(r + 1) * cell;
+            const float x0 = startX + (float)bc * cell;
             const float x1 = x0 + cell;
-            const float y1 = y0 + cell;
 
-            const uint8_t v = (uint8_t)grid[r][c];
-            const bool isXY = (c == uiStartX && r == uiStartY);
+            uint8_t v = 0;
+            float alpha = 0.0f;
+            float wallShare = -1.0f;   // >= 0：没有标记的多格块
+            if (step == 1)
+            {
+                const size_t idx = m.Index(bc, br);
+                v = shade(idx);
+                if (idx < cellAlphaOverride.size()) alpha = cellAlphaOverride[idx];
+            }
+            else
+            {
+                int walls = 0, cells = 0;
+                for (int r = br * step; r < std::min(rows, (br + 1) * step); ++r)
+                    for (int c = bc * step; c < std::min(cols, (bc + 1) * step); ++c)
+                    {
+                        const size_t idx = m.Index(c, r);
+                        const uint8_t cv = shade(idx);
+                        ++cells;
+                        walls += cv == 1;
+                        if (markRank(cv) > markRank(v)) v = cv;
+                        if (cv == 6 && idx < cellAlphaOverride.size()) alpha = std::max(alpha, cellAlphaOverride[idx]);
+                    }
+                if (markRank(v) == 0) wallShare = std::round((float)walls * 8.0f / (float)cells) / 8.0f;
+            }
 
             // 特殊 tile 27: 墙体+BREAK覆盖
             if (v == 27 || v == 18)
             {
+                flush();
                 PushRect(verts, x0, y0, x1, y1, wallR, wallG, wallB, opaqueA);
                 const float shrink = 0.50f;
                 const float pad = cell * (1.0f - shrink) * 0.5f;
                 PushRect(verts, x0 + pad, y0 + pad, x1 - pad, y1 - pad, bfs2R, bfs2G, bfs2B, opaqueA);
-
-                if (isXY)
-                {
-                    const float pad2 = cell * (1.0f - xyShrink) * 0.5f;
-                    PushRect(verts, x0 + pad2, y0 + pad2, x1 - pad2, y1 - pad2, xyR, xyG, xyB, opaqueA);
-                }
                 continue;
             }
 
@@ -90,22 +134,35 @@ void Viewer::rebuildMeshFromMaze(const Maze& m)
                 case 19: rr = passR; gg = passG; bb = passB; aa = visitedA; break;
             }
 
-            // Floyd 算法支持透明度覆盖
-            if (v == 6 && alphaOverrideActive)
+            if (wallShare >= 0.0f)
             {
-                const size_t idx = (size_t)r * (size_t)cols + (size_t)c;
-                if (idx < cellAlphaOverride.size())
-                    aa = std::clamp(cellAlphaOverride[idx], 0.0f, 1.0f);
+                rr = pathR + (wallR - pathR) * wallShare;
+                gg = pathG + (wallG - pathG) * wallShare;
+                bb = pathB + (wallB - pathB) * wallShare;
             }
 
-            PushRect(verts, x0, y0, x1, y1, rr, gg, bb, aa);
+            // Floyd 算法支持透明度覆盖
+            if (v == 6 && alphaOverrideActive)
+                aa = std::clamp(alpha, 0.0f, 1.0f);
 
-            if (isXY)
+            if (run.c0 >= 0 && run.c1 == bc && run.r == rr && run.g == gg && run.b == bb && run.a == aa)
             {
-                const float pad2 = cell * (1.0f - xyShrink) * 0.5f;
-                PushRect(verts, x0 + pad2, y0 + pad2, x1 - pad2, y1 - pad2, xyR, xyG, xyB, opaqueA);
+                run.c1 = bc + 1;
+                continue;
             }
+            flush();
+            run = { bc, bc + 1, rr, gg, bb, aa };
         }
+        flush();
+    }
+
+    // 起点标记画在最上层
+    if (uiStartX >= 0 && uiStartY >= 0 && uiStartX < cols && uiStartY < rows)
+    {
+        const float x0 = startX + (float)(uiStartX / step) * cell;
+        const float y0 = startY - (float)(uiStartY / step + 1) * cell;
+        const float pad2 = cell * (1.0f - xyShrink) * 0.5f;
+        PushRect(verts, x0 + pad2, y0 + pad2, x0 + cell - pad2, y0 + cell - pad2, xyR, xyG, xyB, opaqueA);
     }
 
     // 上传顶点数据到 OpenGL 缓冲区
@@ -196,6 +196,17 @@ static void DrawBtnLabel(std::vector<Vertex>& out,
     PushText5x7(out, label, tx, ty, pix, pix, r, g, b);
 }
 
+// PATH 旁模式框里的短标签
+static std::string_view SearchModeLabel(SearchMode mode)
+{
+    switch (mode)
+    {
+        case SearchMode::JumpPoint:     return "JP";
+        case SearchMode::Bidirectional: return "BI";
+        default:                        return "A*";
+    }
+}
+
 // 渲染左侧 UI 面板：按钮、输入框与结果展示，并上传顶点到 OpenGL 绘制
 void Viewer::renderUi()
 {
@@ -393,17 +404,81 @@ void Viewer::renderUi()
     }
     // --- add
 
+    // ---- SIZE: W / H input boxes (below the result box)
+    {
+        const float resY0 = xyY0 - gap - 0.11f;
+
+        const float sizeLabelY1 = resY0 - gap;
+        const float sizeLabelY0 = sizeLabelY1 - seedLabelH;
+
+        const float sizeY1 = sizeLabelY0 - 0.012f;
+        const float sizeY0 = sizeY1 - xyH;
+
+        PushText5x7(ui, "W",
+                     xBoxX0, sizeLabelY0,
+                     seedLabelPix, seedLabelPix,
+                     0.92f, 0.92f, 0.92f);
+        PushText5x7(ui, "H",
+                     yBoxX0, sizeLabelY0,
+                     seedLabelPix, seedLabelPix,
+                     0.92f, 0.92f, 0.92f);
+
+        drawBox(xBoxX0, sizeY0, xBoxX1, sizeY1, uiFocus == UI::MazeW);
+        drawBox(yBoxX0, sizeY0, yBoxX1, sizeY1, uiFocus == UI::MazeH);
+
+        int wShown = uiMazeW;
+        int hShown = uiMazeH;
+
+        if (uiFocus == UI::MazeW && !uiEdit.empty())
+        {
+            char* end = nullptr;
+            const long v = std::strtol(uiEdit.c_str(), &end, 10);
+            if (end != uiEdit.c_str())
+                wShown = (int)v;
+        }
+        if (uiFocus == UI::MazeH && !uiEdit.empty())
+        {
+            char* end = nullptr;
+            const long v = std::strtol(uiEdit.c_str(), &end, 10);
+            if (end != uiEdit.c_str())
+                hShown = (int)v;
+        }
+
+        PushInt7Tight(ui, wShown,
+                      xBoxX0 + 0.02f, sizeY0 + 0.02f,
+                      (xBoxX1 - xBoxX0) - 0.04f, (sizeY1 - sizeY0) - 0.04f,
+                      0.92f, 0.92f, 0.92f);
+
+        PushInt7Tight(ui, hShown,
+                      yBoxX0 + 0.02f, sizeY0 + 0.02f,
+                      (yBoxX1 - yBoxX0) - 0.04f, (sizeY1 - sizeY0) - 0.04f,
+                      0.92f, 0.92f, 0.92f);
+    }
+
     // ---- Bottom: PATH / BREAK[...] / COUNT
     const float btnH = 0.11f;
     const float btnGap = 0.018f;
     const float bottomY0 = panelY0 + padY;
 
-    // Row 0: PATH
+    // Row 0: PATH + [search mode box]
     {
         const float y0 = bottomY0 + 0 * (btnH + btnGap);
         const float y1 = y0 + btnH;
-        PushRect(ui, contentX0, y0, contentX1, y1, 0.20f, 0.55f, 1.00f);
-        DrawBtnLabel(ui, "PATH", contentX0, y0, contentX1, y1);
+
+        const float boxW = btnH;     // square, same as BREAK's count box
+        const float boxGap = 0.012f;
+
+        const float boxX0 = contentX1 - boxW;
+        const float boxX1 = contentX1;
+        const float btnX0 = contentX0;
+        const float btnX1 = boxX0 - boxGap;
+
+        PushRect(ui, btnX0, y0, btnX1, y1, 0.20f, 0.55f, 1.00f);
+        DrawBtnLabel(ui, "PATH", btnX0, y0, btnX1, y1);
+
+        // search mode box: click to cycle A* / JPS / bidirectional
+        drawBox(boxX0, y0, boxX1, y1, false);
+        DrawBtnLabel(ui, SearchModeLabel(searchCtx.mode), boxX0, y0, boxX1, y1, 0.0075f, 0.92f, 0.92f, 0.92f);
     }
 
     // Row 1: BREAK + [breakCount box]
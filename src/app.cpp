@@ -4,8 +4,8 @@
 #include "core/PathFinder.hpp"
 
 
-void runApp()
+void runApp(const std::string& mazePath)
 {
     auto& viewer = Viewer::getInstance();
-    viewer.run();
+    viewer.run(mazePath);
 }
\ No newline at end of file
@@ -0,0 +1,824 @@
+#include "core/Common.hpp"
+#include "core/ChunkWorld.hpp"
+#include "core/JunctionGraph.hpp"
+#include "core/MazeBuilder.hpp"
+#include "core/PathFinder.hpp"
+#include "core/Random.hpp"
+#include "core/StaticMaze.hpp"
+#include "core/WordRows.hpp"
+
+#include <random>
+
+// 命令行基准：MazeGame --bench
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double NsPer(Clock::duration d, size_t n)
+    {
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        return n ? ns / (double)n : 0.0;
+    }
+
+    // 旧写法：每次邻居扩展都 InBounds，再 IsWall（IsWall 内部再查一次越界）
+    size_t FloodChecked(const Maze& maze, std::vector<uint8_t>& seen, std::vector<Point>& queue)
+    {
+        const int dx[4] = { 1, -1, 0, 0 };
+        const int dy[4] = { 0, 0, 1, -1 };
+
+        std::fill(seen.begin(), seen.end(), 0);
+        queue.clear();
+        queue.push_back(maze.start);
+        seen[maze.Index(maze.start.x, maze.start.y)] = 1;
+
+        size_t expansions = 0;
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            const Point cur = queue[head];
+            for (int i = 0; i < 4; ++i)
+            {
+                const int nx = cur.x + dx[i];
+                const int ny = cur.y + dy[i];
+                ++expansions;
+
+                if (!maze.InBounds(nx, ny) || maze.IsWall(nx, ny)) continue;
+
+                const size_t k = maze.Index(nx, ny);
+                if (seen[k]) continue;
+                seen[k] = 1;
+                queue.push_back({ nx, ny });
+            }
+        }
+        return expansions;
+    }
+
+    // 新写法：哨兵外圈 + 线性偏移，一次查表
+    size_t FloodPadded(const PaddedGrid& grid, Point start, std::vector<uint8_t>& seen, std::vector<size_t>& queue)
+    {
+        const auto& off = grid.offsets;
+
+        std::copy(grid.cells.begin(), grid.cells.end(), seen.begin());
+        queue.clear();
+        const size_t s = grid.Index(start.x, start.y);
+        queue.push_back(s);
+        seen[s] = PaddedGrid::Wall;
+
+        size_t expansions = 0;
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            const size_t cur = queue[head];
+            for (int i = 0; i < 4; ++i)
+            {
+                const size_t n = cur + off[i];
+                ++expansions;
+
+                if (seen[n]) continue;
+                seen[n] = PaddedGrid::Wall;
+                queue.push_back(n);
+            }
+        }
+        return expansions;
+    }
+
+    void BenchNeighbourExpansion()
+    {
+        constexpr int ROUNDS = 2000;
+
+        Maze maze = MazeBuilder::Build(1);
+        maze.start = { 1, 1 };
+        maze.end = { maze.width - 2, maze.height - 2 };
+
+        std::vector<uint8_t> seenChecked(maze.CellCount());
+        std::vector<Point> queueChecked;
+        size_t nChecked = 0;
+
+        auto t0 = Clock::now();
+        for (int r = 0; r < ROUNDS; ++r)
+            nChecked += FloodChecked(maze, seenChecked, queueChecked);
+        const auto dChecked = Clock::now() - t0;
+
+        const PaddedGrid grid = PaddedGrid::FromMaze(maze);
+        std::vector<uint8_t> seenPadded(grid.Size());
+        std::vector<size_t> queuePadded;
+        size_t nPadded = 0;
+
+        t0 = Clock::now();
+        for (int r = 0; r < ROUNDS; ++r)
+            nPadded += FloodPadded(grid, maze.start, seenPadded, queuePadded);
+        const auto dPadded = Clock::now() - t0;
+
+        std::cout << "[expand] " << maze.width << "x" << maze.height << " x" << ROUNDS << " flood fills\n"
+                  << "  bounds-checked : " << NsPer(dChecked, nChecked) << " ns/expansion\n"
+                  << "  sentinel-padded: " << NsPer(dPadded, nPadded) << " ns/expansion\n";
+    }
+
+    // 旧 A*：cameFrom / costSoFar 放在哈希表里，每次松弛先 count 再 operator[]
+    size_t AStarHashed(const PaddedGrid& grid, Point start, Point end)
+    {
+        struct Node { Point p; size_t idx; int g; int f; };
+        auto cmp = [](const Node& a, const Node& b) { return a.f > b.f; };
+        auto h = [&](Point a) { return std::abs(a.x - end.x) + std::abs(a.y - end.y); };
+
+        const int dx[4] = { 1, -1, 0, 0 };
+        const int dy[4] = { 0, 0, 1, -1 };
+        const auto& off = grid.offsets;
+
+        std::priority_queue<Node, std::vector<Node>, decltype(cmp)> openSet(cmp);
+        std::unordered_map<size_t, Point> cameFrom;
+        std::unordered_map<size_t, int> costSoFar;
+
+        const size_t s = grid.Index(start.x, start.y);
+        openSet.push({ start, s, 0, h(start) });
+        costSoFar[s] = 0;
+
+        while (!openSet.empty())
+        {
+            const Node cur = openSet.top();
+            openSet.pop();
+            if (cur.p == end)
+            {
+                size_t len = 1;
+                for (Point p = end; !(p == start); p = cameFrom[grid.Index(p.x, p.y)]) ++len;
+                return len;
+            }
+            for (int i = 0; i < 4; ++i)
+            {
+                const size_t k = cur.idx + off[i];
+                if (grid.cells[k] != PaddedGrid::Open) continue;
+                const int ng = cur.g + 1;
+                if (!costSoFar.count(k) || ng < costSoFar[k])
+                {
+                    costSoFar[k] = ng;
+                    const Point np{ cur.p.x + dx[i], cur.p.y + dy[i] };
+                    openSet.push({ np, k, ng, ng + h(np) });
+                    cameFrom[k] = cur.p;
+                }
+            }
+        }
+        return 0;
+    }
+
+    // 同一迷宫上反复查随机房间对：哈希表版 vs SearchContext（平铺数组 + 纪元），后者预热后不应再分配；
+    // 再换成桶队列、跳点搜索、双向 A*、路口图
+    void BenchSearchContext()
+    {
+        constexpr int QUERIES = 50;
+
+        Maze maze = MazeBuilder::Build(1, 1001, 1001);
+        const int32_t rooms = (maze.width - 1) / 2;
+
+        std::vector<std::pair<Point, Point>> queries;
+        Xoshiro256 rng(7);
+        auto room = [&] {
+            return Point{ (int32_t)UniformBelow(rng, (uint64_t)rooms) * 2 + 1, (int32_t)UniformBelow(rng, (uint64_t)rooms) * 2 + 1 };
+        };
+        for (int i = 0; i < QUERIES; ++i) queries.push_back({ room(), room() });
+
+        const PaddedGrid grid = PaddedGrid::FromMaze(maze);
+        size_t lenHashed = 0;
+        auto t0 = Clock::now();
+        for (const auto& [a, b] : queries) lenHashed += AStarHashed(grid, a, b);
+        const auto dHashed = Clock::now() - t0;
+
+        SearchContext ctx;
+        SearchResult out;
+        ctx.Bind(maze);
+        PathFinder::pathFinder(ctx, queries[0].first, queries[0].second, out);   // 预热
+
+        const auto* gData = ctx.g.data();
+        const size_t openCap = ctx.open.capacity();
+        const size_t visitedCap = out.visited.capacity();
+
+        size_t lenFlat = 0;
+        t0 = Clock::now();
+        for (const auto& [a, b] : queries)
+        {
+            PathFinder::pathFinder(ctx, a, b, out);
+            lenFlat += (size_t)out.length;
+        }
+        const auto dFlat = Clock::now() - t0;
+
+        // 预热之后容量只会在更远的查询上增长一次，之后保持不变
+        size_t regrown = 0;
+        for (const auto& [a, b] : queries)
+        {
+            const size_t oc = ctx.open.capacity(), vc = out.visited.capacity(), pc = out.path.capacity();
+            PathFinder::pathFinder(ctx, a, b, out);
+            regrown += (ctx.open.capacity() != oc) + (out.visited.capacity() != vc) + (out.path.capacity() != pc);
+        }
+
+        // 同一工作区换成按 f 分桶的开放表
+        ctx.openList = OpenListPolicy::Buckets;
+        PathFinder::pathFinder(ctx, queries[0].first, queries[0].second, out);
+        size_t lenBuckets = 0;
+        t0 = Clock::now();
+        for (const auto& [a, b] : queries)
+        {
+            PathFinder::pathFinder(ctx, a, b, out);
+            lenBuckets += (size_t)out.length;
+        }
+        const auto dBuckets = Clock::now() - t0;
+
+        // 同一组查询换成跳点搜索：比较展开的节点数
+        size_t expandedAStar = 0;
+        for (const auto& [a, b] : queries)
+        {
+            PathFinder::pathFinder(ctx, a, b, out);
+            expandedAStar += (size_t)out.expanded;
+        }
+
+        ctx.mode = SearchMode::JumpPoint;
+        size_t lenJump = 0, expandedJump = 0;
+        t0 = Clock::now();
+        for (const auto& [a, b] : queries)
+        {
+            PathFinder::pathFinder(ctx, a, b, out);
+            lenJump += (size_t)out.length;
+            expandedJump += (size_t)out.expanded;
+        }
+        const auto dJump = Clock::now() - t0;
+
+        ctx.mode = SearchMode::Bidirectional;
+        size_t lenBi = 0, expandedBi = 0;
+        t0 = Clock::now();
+        for (const auto& [a, b] : queries)
+        {
+            PathFinder::pathFinder(ctx, a, b, out);
+            lenBi += (size_t)out.length;
+            expandedBi += (size_t)out.expanded;
+        }
+        const auto dBi = Clock::now() - t0;
+
+        // 路口图：建一次，之后同一组查询只在收缩后的图上跑
+        ctx.mode = SearchMode::AStar;
+        const JunctionGraph graph(maze);
+        PathFinder::pathFinder(graph, ctx, queries[0].first, queries[0].second, out);
+        size_t lenGraph = 0, expandedGraph = 0;
+        t0 = Clock::now();
+        for (const auto& [a, b] : queries)
+        {
+            PathFinder::pathFinder(graph, ctx, a, b, out);
+            lenGraph += (size_t)out.length;
+            expandedGraph += (size_t)out.expanded;
+        }
+        const auto dGraph = Clock::now() - t0;
+
+        std::cout << "[astar] " << maze.width << "x" << maze.height << " x" << QUERIES << " room-pair queries\n"
+                  << "  hashed maps   : " << NsPer(dHashed, QUERIES) / 1000.0 << " us/query\n"
+                  << "  search context: " << NsPer(dFlat, QUERIES) / 1000.0 << " us/query"
+                  << " (lengths " << (lenHashed == lenFlat ? "match" : "DIFFER")
+                  << ", regrowth on second pass " << regrown
+                  << ", g array moved " << (gData != ctx.g.data()) << ", open " << openCap << "->" << ctx.open.capacity()
+                  << ", visited " << visitedCap << "->" << out.visited.capacity() << ")\n"
+                  << "  bucket queue  : " << NsPer(dBuckets, QUERIES) / 1000.0 << " us/query"
+                  << " (lengths " << (lenHashed == lenBuckets ? "match" : "DIFFER") << ", " << expandedAStar / QUERIES << " expanded/query)\n"
+                  << "  jump points   : " << NsPer(dJump, QUERIES) / 1000.0 << " us/query"
+                  << " (lengths " << (lenHashed == lenJump ? "match" : "DIFFER") << ", " << expandedJump / QUERIES << " expanded/query)\n"
+                  << "  bidirectional : " << NsPer(dBi, QUERIES) / 1000.0 << " us/query"
+                  << " (lengths " << (lenHashed == lenBi ? "match" : "DIFFER") << ", " << expandedBi / QUERIES << " expanded/query)\n"
+                  << "  junction graph: " << NsPer(dGraph, QUERIES) / 1000.0 << " us/query"
+                  << " (lengths " << (lenHashed == lenGraph ? "match" : "DIFFER") << ", " << expandedGraph / QUERIES << " expanded/query; "
+                  << graph.NodeCount() << " nodes / " << graph.EdgeCount() << " edges for " << maze.CellCount() << " cells, built in "
+                  << graph.BuildTime().count() / 1000.0 << " ms, " << graph.MemoryBytes() / 1024 << " KiB)\n";
+    }
+
+    // 校验用的小迷宫：layout 0..3 为不同打环比例（0 是完美迷宫），4 是几乎全通的开阔网格，
+    // 5 只有一个全是度数 2 格子的环和一条孤立的直走廊（路口图里要补节点）
+    Maze CheckMaze(int seed, int layout)
+    {
+        BuildOptions options;
+        options.braidRatio = 0.2 * std::min(layout, 3);
+        Maze maze = MazeBuilder::Build(seed, 101 + seed % 3 * 2, 61, options);
+        if (layout == 4)
+        {
+            for (int32_t y = 1; y < maze.height - 1; ++y)
+                for (int32_t x = 1; x < maze.width - 1; ++x)
+                    if ((x * 7 + y * 3) % 11) maze.SetWall(x, y, false);
+        }
+        else if (layout == 5)
+        {
+            for (int32_t y = 1; y < maze.height - 1; ++y)
+                for (int32_t x = 1; x < maze.width - 1; ++x)
+                    maze.SetWall(x, y, !((y == 3 || y == 9) && x >= 3 && x <= 20) && !((x == 3 || x == 20) && y >= 3 && y <= 9)
+                                       && !(y == 5 && x >= 30 && x <= 40));
+        }
+        return maze;
+    }
+
+    // 路径从 start 到 end、格数等于 length、每步相邻且不进墙（起点本身在墙里时 A* 照样从它出发）
+    bool PathValid(const Maze& maze, Point start, Point end, const SearchResult& r)
+    {
+        if (r.length == 0) return r.path.empty();
+        if (r.path.size() != (size_t)r.length || r.path.front() != start || r.path.back() != end) return false;
+        for (size_t i = 1; i < r.path.size(); ++i)
+        {
+            const Point p = r.path[i];
+            if (maze.IsWall(p.x, p.y) || std::abs(p.x - r.path[i - 1].x) + std::abs(p.y - r.path[i - 1].y) != 1) return false;
+        }
+        return true;
+    }
+
+    // 随机起终点对拍：跳点与双向在两种开放表下都要与 A* 同长度，且路径合法
+    void CheckSearchModes()
+    {
+        constexpr int SEEDS = 8;
+        constexpr int QUERIES = 60;
+
+        size_t queries = 0, bad = 0;
+        for (int seed = 0; seed < SEEDS; ++seed)
+            for (int layout = 0; layout <= 4; ++layout)
+            {
+                const Maze maze = CheckMaze(seed, layout);
+                for (const auto policy : { OpenListPolicy::BinaryHeap, OpenListPolicy::Buckets })
+                {
+                    SearchContext ref{ .openList = policy };
+                    SearchContext ctx{ .openList = policy };
+                    ref.Bind(maze);
+                    ctx.Bind(maze);
+                    SearchResult want, got;
+
+                    Xoshiro256 rng((uint64_t)(seed * 16 + layout));
+                    for (int q = 0; q < QUERIES; ++q)
+                    {
+                        // 含起点即终点、落在墙上的端点
+                        const Point a{ UniformInt(rng, 1, maze.width - 2), UniformInt(rng, 1, maze.height - 2) };
+                        const Point b = (q % 5 == 0) ? a : Point{ UniformInt(rng, 1, maze.width - 2), UniformInt(rng, 1, maze.height - 2) };
+
+                        PathFinder::pathFinder(ref, a, b, want);
+                        for (const auto mode : { SearchMode::JumpPoint, SearchMode::Bidirectional })
+                        {
+                            ctx.mode = mode;
+                            PathFinder::pathFinder(ctx, a, b, got);
+                            ++queries;
+                            if (got.length != want.length || !PathValid(maze, a, b, got))
+                            {
+                                if (bad++ < 5)
+                                    std::cout << "  mismatch: " << (mode == SearchMode::JumpPoint ? "jump points" : "bidirectional") << " seed " << seed << " layout " << layout
+                                              << " (" << a.x << "," << a.y << ")->(" << b.x << "," << b.y << ") "
+                                              << got.length << " vs " << want.length << "\n";
+                            }
+                        }
+                    }
+                }
+            }
+
+        std::cout << "[check] jump points / bidirectional vs A*: " << queries << " queries, "
+                  << bad << " mismatches\n";
+    }
+
+    // 路口图对拍：与网格 A* 同长度且路径合法。端点只取通路格（图上搜索对墙里的端点直接返回无路），
+    // 三分之一的终点从起点随机走几步得到，多半与起点在同一条走廊里
+    void CheckJunctionGraph()
+    {
+        constexpr int SEEDS = 8;
+        constexpr int QUERIES = 200;
+
+        size_t queries = 0, bad = 0;
+        for (int seed = 0; seed < SEEDS; ++seed)
+            for (int layout = 0; layout <= 5; ++layout)
+            {
+                const Maze maze = CheckMaze(seed, layout);
+                const JunctionGraph graph(maze);
+
+                std::vector<Point> cells;
+                for (int32_t y = 0; y < maze.height; ++y)
+                    for (int32_t x = 0; x < maze.width; ++x)
+                        if (!maze.IsWall(x, y)) cells.push_back({ x, y });
+
+                for (const auto policy : { OpenListPolicy::BinaryHeap, OpenListPolicy::Buckets })
+                {
+                    SearchContext ref{ .openList = policy };
+                    SearchContext ctx{ .openList = policy };
+                    ref.Bind(maze);
+                    SearchResult want, got;
+
+                    Xoshiro256 rng((uint64_t)(seed * 16 + layout));
+                    for (int q = 0; q < QUERIES; ++q)
+                    {
+                        const Point a = cells[UniformBelow(rng, cells.size())];
+                        Point b = cells[UniformBelow(rng, cells.size())];
+                        if (q % 3 == 0)
+                        {
+                            b = a;
+                            for (int step = UniformInt(rng, 0, 6); step > 0; --step)
+                            {
+                                const int dx[4] = { 1, -1, 0, 0 };
+                                const int dy[4] = { 0, 0, 1, -1 };
+                                const int d = (int)UniformBelow(rng, 4);
+                                if (!maze.IsWall(b.x + dx[d], b.y + dy[d])) b = { b.x + dx[d], b.y + dy[d] };
+                            }
+                        }
+
+                        PathFinder::pathFinder(ref, a, b, want);
+                        PathFinder::pathFinder(graph, ctx, a, b, got);
+                        ++queries;
+                        if (got.length != want.length || !PathValid(maze, a, b, got))
+                        {
+                            if (bad++ < 5)
+                                std::cout << "  mismatch: seed " << seed << " layout " << layout
+                                          << " (" << a.x << "," << a.y << ")->(" << b.x << "," << b.y << ") "
+                                          << got.length << " vs " << want.length << "\n";
+                        }
+                    }
+                }
+            }
+
+        std::cout << "[check] junction graph vs A*: " << queries << " queries, " << bad << " mismatches\n";
+    }
+
+    // 生成耗时与内存随边长的变化：应当与格数成正比
+    void BenchBuildScaling()
+    {
+        // 默认尺寸反复生成：看单次生成的固定开销
+        {
+            constexpr int N = 20000;
+            const auto t0 = Clock::now();
+            size_t sink = 0;
+            for (int i = 0; i < N; ++i)
+                sink += MazeBuilder::Build(i).walls.Data()[0] & 1;
+            const auto d = Clock::now() - t0;
+
+            std::cout << "[build] " << MazeBuilder::DefaultSize << "x" << MazeBuilder::DefaultSize << " x" << N << ": "
+                      << NsPer(d, N) / 1000.0 << " us/maze (" << sink << ")\n";
+        }
+
+        for (int32_t side : { 1001, 4001, 10001 })
+        {
+            const auto t0 = Clock::now();
+            const Maze maze = MazeBuilder::Build(1, side, side);
+            const auto d = Clock::now() - t0;
+
+            std::cout << "[build] " << maze.width << "x" << maze.height << ": "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(d).count() << " ms, "
+                      << NsPer(d, maze.CellCount()) << " ns/cell, "
+                      << maze.walls.MemoryBytes() / 1024 << " KiB walls\n";
+        }
+    }
+
+    // 各生成算法的吞吐（百万房间/秒），不含打环
+    void BenchGenerators()
+    {
+        for (int32_t side : { 1001, 4001 })
+        {
+            std::cout << "[generators] " << side << "x" << side << "\n";
+            for (int32_t g = 0; g < MazeBuilder::GeneratorCount; ++g)
+            {
+                BuildOptions options;
+                options.generator = (MazeGenerator)g;
+                options.extraLoops = 0;
+
+                const Maze maze = MazeBuilder::Build(1, side, side, options);
+                const double rooms = (double)((side - 1) / 2) * (double)((side - 1) / 2);
+                const double us = (double)maze.buildTime.count();
+
+                std::cout << "  " << MazeBuilder::GeneratorName(maze.generator) << ": "
+                          << us / 1000.0 << " ms, "
+                          << (us > 0 ? rooms / us : 0.0) << " Mrooms/s\n";
+            }
+        }
+    }
+
+    // 打环开销：同一迷宫不打环 / 打几条 / 按比例 / 去死路，差值即打环本身的耗时
+    void BenchBraid()
+    {
+        constexpr int32_t Side = 4001;
+        struct Case { const char* name; BraidMode mode; double ratio; int32_t loops; };
+        const Case cases[] = {
+            { "none",           BraidMode::Walls,    0.0,  0 },
+            { "10 loops",       BraidMode::Walls,    0.0,  10 },
+            { "walls 1%",       BraidMode::Walls,    0.01, 0 },
+            { "walls 100%",     BraidMode::Walls,    1.0,  0 },
+            { "dead ends 50%",  BraidMode::DeadEnds, 0.5,  0 },
+        };
+
+        std::cout << "[braid] " << Side << "x" << Side << " sidewinder-simd\n";
+        for (const Case& c : cases)
+        {
+            BuildOptions options;
+            options.generator = MazeGenerator::SidewinderSimd;
+            options.braid = c.mode;
+            options.braidRatio = c.ratio;
+            options.extraLoops = c.loops;
+
+            const Maze maze = MazeBuilder::Build(1, Side, Side, options);
+            std::cout << "  " << c.name << ": " << (double)maze.buildTime.count() / 1000.0 << " ms\n";
+        }
+    }
+
+    // 整字生成：只展开网格行不落位图的纯生成速度，标量 / AVX2 各一次；再测写进位图的整次 Build
+    void BenchWordRows()
+    {
+        constexpr int32_t SIDE = 10001;
+        constexpr int32_t ROOMS = (SIDE - 1) / 2;
+        const double cells = (double)SIDE * (double)SIDE;
+
+        std::cout << "[word rows] " << SIDE << "x" << SIDE << (WordRows::HasAvx2() ? "" : " (no AVX2)") << "\n";
+        for (WordRows::Kind kind : { WordRows::Kind::BinaryTree, WordRows::Kind::Sidewinder })
+        {
+            const char* name = (kind == WordRows::Kind::BinaryTree) ? "binary-tree" : "sidewinder";
+            for (bool avx2 : { false, true })
+            {
+                if (avx2 && !WordRows::HasAvx2()) continue;
+
+                Xoshiro256 rng(1);
+                WordRows rows(kind, ROOMS, rng, avx2);
+                std::vector<uint64_t> gapRow(rows.RowWords()), roomRow(rows.RowWords());
+                uint64_t sink = 0;
+
+                const auto t0 = Clock::now();
+                for (int32_t ry = 0; ry < ROOMS; ++ry)
+                {
+                    rows.Next();
+                    rows.Expand(gapRow, roomRow);
+                    sink ^= gapRow[0] ^ roomRow.back();
+                }
+                const double s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+                std::cout << "  " << name << (avx2 ? " avx2  : " : " scalar: ") << s * 1000.0 << " ms, "
+                          << (s > 0 ? cells / s / 1e9 : 0.0) << " Gcells/s (" << (sink & 1) << ")\n";
+            }
+        }
+
+        for (MazeGenerator g : { MazeGenerator::BinaryTreeSimd, MazeGenerator::SidewinderSimd })
+        {
+            BuildOptions options;
+            options.generator = g;
+            options.extraLoops = 0;
+
+            const Maze maze = MazeBuilder::Build(1, SIDE, SIDE, options);
+            const double us = (double)maze.buildTime.count();
+            std::cout << "  Build " << MazeBuilder::GeneratorName(g) << ": " << us / 1000.0 << " ms, "
+                      << (us > 0 ? cells / us / 1000.0 : 0.0) << " Gcells/s\n";
+        }
+    }
+
+    // Eller 流式生成：行交给回调后即丢弃，测纯生成吞吐（位图 MB/s）
+    void BenchStream()
+    {
+        constexpr int32_t W = 4001;
+        constexpr int32_t H = 40001;
+
+        uint64_t sink = 0;
+        const auto t0 = Clock::now();
+        MazeBuilder::BuildStream(1, W, H, [&](int32_t, std::span<const uint64_t> row) {
+            sink ^= row[0];
+        });
+        const auto d = Clock::now() - t0;
+
+        const double mb = (double)W * (double)H / 8.0 / (1024.0 * 1024.0);
+        const double s = std::chrono::duration<double>(d).count();
+        std::cout << "[stream] eller " << W << "x" << H << ": " << s * 1000.0 << " ms, "
+                  << (s > 0 ? mb / s : 0.0) << " MB/s of bitmap (" << (sink & 1) << ")\n";
+    }
+
+    // 位图内容的 FNV-1a 摘要，用来确认不同线程数的输出逐位一致
+    uint64_t Digest(const WallBitmap& walls)
+    {
+        uint64_t h = 1469598103934665603ull;
+        for (size_t i = 0; i < walls.WordCount(); ++i)
+            h = (h ^ walls.Data()[i]) * 1099511628211ull;
+        return h;
+    }
+
+    // 分块并行生成：整体 DFS 作对照，分块模式按 1 / 2 / 4 / ... / 硬件线程数各跑一次
+    void BenchTiled()
+    {
+        constexpr int32_t SIDE = 10001;
+
+        const Maze serial = MazeBuilder::Build(1, SIDE, SIDE);
+        std::cout << "[tiled] " << SIDE << "x" << SIDE << "\n"
+                  << "  whole-grid dfs: " << serial.buildTime.count() / 1000 << " ms\n";
+
+        const int32_t hw = (int32_t)std::max(1u, std::thread::hardware_concurrency());
+        for (int32_t threads = 1; ; threads = std::min(threads * 2, hw))
+        {
+            BuildOptions options;
+            options.tileRooms = 256;
+            options.threads = threads;
+
+            const Maze maze = MazeBuilder::Build(1, SIDE, SIDE, options);
+            std::cout << "  tiles 256, " << threads << " thread(s): " << maze.buildTime.count() / 1000 << " ms, digest "
+                      << std::hex << Digest(maze.walls) << std::dec << "\n";
+
+            if (threads == hw) break;
+        }
+    }
+
+    // 随机数层：每种生成器 / 用法的吞吐（百万次/秒）。sink 防止循环被优化掉
+    template <class F>
+    void BenchDraws(const char* name, size_t n, F&& draw)
+    {
+        uint64_t sink = 0;
+        const auto t0 = Clock::now();
+        for (size_t i = 0; i < n; ++i) sink += draw(i);
+        const double ns = NsPer(Clock::now() - t0, n);
+        std::cout << "  " << name << ": " << ns << " ns/draw, " << (ns > 0 ? 1000.0 / ns : 0.0)
+                  << " M/s (" << (sink & 1) << ")\n";
+    }
+
+    void BenchRng()
+    {
+        constexpr size_t N = 20'000'000;
+        std::cout << "[rng] " << N << " draws\n";
+
+        std::mt19937 mt(1);
+        BenchDraws("mt19937 (32-bit)", N, [&](size_t) { return (uint64_t)mt(); });
+
+        Xoshiro256 xo(1);
+        BenchDraws("xoshiro256** (64-bit)", N, [&](size_t) { return xo.Next64(); });
+
+        Pcg32 pcg(1);
+        BenchDraws("pcg32 (32-bit)", N, [&](size_t) { return (uint64_t)pcg.Next32(); });
+
+        // 按 (seed, tile, cell) 寻址，每次 128 位
+        BenchDraws("philox4x32-10 At(seed, tile, cell)", N, [&](size_t i) { return Philox::At64(1, 7, i); });
+
+        std::uniform_int_distribution<int> d6(0, 5);
+        BenchDraws("mt19937 + uniform_int_distribution [0,6)", N, [&](size_t) { return (uint64_t)d6(mt); });
+        BenchDraws("xoshiro256** + UniformBelow(6)", N, [&](size_t) { return UniformBelow(xo, 6); });
+
+        // 洗牌 4 个方向，回溯法每个房间一次
+        std::array<int, 4> dirs{ 0, 1, 2, 3 };
+        BenchDraws("std::shuffle(4) with mt19937", N / 4, [&](size_t) {
+            std::shuffle(dirs.begin(), dirs.end(), mt);
+            return (uint64_t)dirs[0];
+        });
+        BenchDraws("Shuffle(4) with xoshiro256**", N / 4, [&](size_t) {
+            Shuffle(dirs.begin(), dirs.end(), xo);
+            return (uint64_t)dirs[0];
+        });
+    }
+
+    // 分块世界：远处取一个 4096 见方的区域（冷：全部现生成；热：全在缓存里），再在 1 MiB 上限下横穿更大的范围
+    void BenchChunks()
+    {
+        constexpr int32_t SIDE = 4096;
+        const int64_t far = 128ll * 1000000;
+
+        ChunkWorld world(1);
+        auto t0 = Clock::now();
+        world.Region(far, far, SIDE, SIDE);
+        const double cold = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+        t0 = Clock::now();
+        world.Region(far, far, SIDE, SIDE);
+        const double warm = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+        std::cout << "[chunks] region " << SIDE << "x" << SIDE << " at " << far << ": cold " << cold << " ms, warm "
+                  << warm << " ms, " << world.CachedChunks() << " chunks / " << world.CachedBytes() / 1024 << " KiB cached\n";
+
+        ChunkWorldOptions capped;
+        capped.memoryCap = 1 << 20;
+        ChunkWorld strip(1, capped);
+        uint64_t walls = 0;
+        t0 = Clock::now();
+        for (int64_t x = -far; x < -far + 64 * SIDE; x += 7)
+            walls += strip.IsWall(x, 1);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        std::cout << "  strip of " << 64 * SIDE << " cells, 1 MiB cap: " << ms << " ms, generated "
+                  << strip.Generated() << ", cached " << strip.CachedBytes() / 1024 << " KiB (" << (walls & 1) << ")\n";
+    }
+
+    // 编译期烤好的 41x41 基准迷宫，与 MazeBuilder::Build(1, 41, 41) 相同
+    constexpr auto StaticFixture = StaticMaze<41, 41>::Generate(1);
+
+    // 定尺寸与动态两条路径：生成一次、四个求解器各一次的平均耗时（同一个迷宫，结果逐位相同）
+    void BenchStatic()
+    {
+        constexpr int REPS = 2000;
+        using Fixed = StaticMaze<41, 41>;
+        using Solver = StaticSolver<41, 41>;
+
+        Maze dynamic = MazeBuilder::Build(1, 41, 41);
+        dynamic.start = StaticFixture.start;
+        dynamic.end = StaticFixture.end;
+        const Point mid{ 21, 1 };
+
+        auto perOp = [&](auto&& fn) {
+            const auto t0 = Clock::now();
+            for (int i = 0; i < REPS; ++i) fn(i);
+            return std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / REPS;
+        };
+
+        uint64_t sink = 0;
+        SearchResult search;
+        CountResult count;
+        PassResult pass;
+
+        std::cout << "[static] 41x41, us per call: dynamic / static\n";
+        const double genD = perOp([&](int i) { sink += MazeBuilder::Build(i, 41, 41).walls.Data()[3]; });
+        const double genS = perOp([&](int i) { sink += Fixed::Generate(i).cells[50]; });
+        std::cout << "  generate:    " << genD << " / " << genS << "\n";
+
+        const double aD = perOp([&](int) { PathFinder::pathFinder(dynamic, search); sink += search.length; });
+        const double aS = perOp([&](int) { Solver::pathFinder(StaticFixture, search); sink += search.length; });
+        std::cout << "  a*:          " << aD << " / " << aS << "\n";
+
+        const double bD = perOp([&](int) { WallBreaker::BreakWalls(dynamic, 3, search); sink += search.length; });
+        const double bS = perOp([&](int) { Solver::BreakWalls<3>(StaticFixture, search); sink += search.length; });
+        std::cout << "  break walls: " << bD << " / " << bS << "\n";
+
+        const double cD = perOp([&](int) { PathCounter::CountPaths(dynamic, dynamic.start, dynamic.end, count); sink += count.ways; });
+        const double cS = perOp([&](int) { Solver::CountPaths(StaticFixture, StaticFixture.start, StaticFixture.end, count); sink += count.ways; });
+        std::cout << "  count paths: " << cD << " / " << cS << "\n";
+
+        const double pD = perOp([&](int) { PathPasser::PassPath(dynamic, mid.x, mid.y, pass); sink += pass.length; });
+        const double pS = perOp([&](int) { Solver::PassPath(StaticFixture, mid.x, mid.y, pass); sink += pass.length; });
+        std::cout << "  pass path:   " << pD << " / " << pS << "  (" << (sink & 1) << ")\n";
+    }
+
+    // 编译期版本与动态版本对拍：同一种子的墙逐位相同，四个求解器的路径、访问顺序、计数都相同
+    void CheckStatic()
+    {
+        constexpr int SEEDS = 300;
+        using Fixed = StaticMaze<41, 41>;
+        using Solver = StaticSolver<41, 41>;
+
+        size_t bad = 0;
+        for (int seed = 0; seed < SEEDS; ++seed)
+        {
+            const Fixed fixed = Fixed::Generate(seed);
+            Maze dynamic = MazeBuilder::Build(seed, 41, 41);
+            dynamic.start = fixed.start;   // Build 不设起终点
+            dynamic.end = fixed.end;
+
+            bool same = true;
+            for (int32_t y = 0; y < 41; ++y)
+                for (int32_t x = 0; x < 41; ++x)
+                    same &= fixed.IsWall(x, y) == dynamic.IsWall(x, y);
+
+            SearchResult want, got;
+            PathFinder::pathFinder(dynamic, want);
+            Solver::pathFinder(fixed, got);
+            same &= want.path == got.path && want.visited == got.visited;
+
+            WallBreaker::BreakWalls(dynamic, 3, want);
+            Solver::BreakWalls<3>(fixed, got);
+            same &= want.path == got.path && want.visited == got.visited;
+
+            CountResult countWant, countGot;
+            PathCounter::CountPaths(dynamic, dynamic.start, dynamic.end, countWant);
+            Solver::CountPaths(fixed, fixed.start, fixed.end, countGot);
+            same &= countWant.ways == countGot.ways && countWant.paths == countGot.paths;
+
+            for (const Point mid : { Point{ 21, 1 }, Point{ 1, 39 }, Point{ 21, 21 } })
+            {
+                PassResult passWant, passGot;
+                PathPasser::PassPath(dynamic, mid.x, mid.y, passWant);
+                Solver::PassPath(fixed, mid.x, mid.y, passGot);
+                same &= passWant.path == passGot.path && passWant.visitedToMid == passGot.visitedToMid
+                     && passWant.visitedFromMid == passGot.visitedFromMid;
+            }
+
+            if (!same && bad++ < 5) std::cout << "  mismatch: seed " << seed << "\n";
+        }
+
+        std::cout << "[check] static vs dynamic 41x41: " << SEEDS << " seeds, " << bad << " mismatches\n";
+    }
+
+    // 批量生成吞吐：41x41，1 个线程到全部硬件线程；sink 只累加摘要，不写盘
+    void BenchBatch()
+    {
+        constexpr int32_t SIDE = 41;
+        constexpr int COUNT = 50000;
+
+        std::vector<int> seeds(COUNT);
+        for (int i = 0; i < COUNT; ++i) seeds[(size_t)i] = i;
+
+        std::cout << "[batch] " << COUNT << " mazes " << SIDE << "x" << SIDE << "\n";
+        const int32_t hw = (int32_t)std::max(1u, std::thread::hardware_concurrency());
+        for (int32_t threads = 1; ; threads = std::min(threads * 2, hw))
+        {
+            std::atomic<uint64_t> digest{ 0 };
+            const auto t0 = Clock::now();
+            MazeBuilder::BuildBatch(seeds, SIDE, SIDE, {}, threads, [&](size_t, const Maze& maze) {
+                digest.fetch_xor(Digest(maze.walls), std::memory_order_relaxed);
+            });
+            const double s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+            std::cout << "  " << threads << " thread(s): " << (s > 0 ? COUNT / s : 0.0) << " mazes/s, digest "
+                      << std::hex << digest.load() << std::dec << "\n";
+
+            if (threads == hw) break;
+        }
+    }
+}
+
+void runBench()
+{
+    BenchRng();
+    BenchNeighbourExpansion();
+    BenchSearchContext();
+    CheckSearchModes();
+    CheckJunctionGraph();
+    BenchBuildScaling();
+    BenchGenerators();
+    BenchWordRows();
+    BenchBraid();
+    BenchStream();
+    BenchTiled();
+    BenchBatch();
+    BenchChunks();
+    BenchStatic();
+    CheckStatic();
+}
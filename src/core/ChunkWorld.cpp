@@ -0,0 +1,123 @@
+#include "core/ChunkWorld.hpp"
+#include "core/MazeBuilder.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    // 行主序位图里从 (x, y) 起写 n 位（n <= 64），可跨一个字边界
+    void PutBits(WallBitmap& walls, int32_t x, int32_t y, uint64_t v, uint32_t n)
+    {
+        uint64_t* data = walls.Data();
+        const size_t bit = walls.BitIndex(x, y);
+        const size_t wi = bit / WallBitmap::WordBits;
+        const uint32_t sh = (uint32_t)(bit % WallBitmap::WordBits);
+        const uint64_t keep = (n == WallBitmap::WordBits) ? ~0ull : ((1ull << n) - 1);
+
+        v &= keep;
+        data[wi] = (data[wi] & ~(keep << sh)) | (v << sh);
+        if (sh != 0 && sh + n > WallBitmap::WordBits)
+        {
+            const uint32_t used = (uint32_t)WallBitmap::WordBits - sh;
+            data[wi + 1] = (data[wi + 1] & ~(keep >> used)) | (v >> used);
+        }
+    }
+}
+
+ChunkWorld::ChunkWorld(int seed, const ChunkWorldOptions& options)
+    : seed(seed), options(options), side(std::clamp(options.chunkRooms, 1, 1 << 14) * 2)
+{
+    this->options.chunkRooms = side / 2;
+}
+
+const WallBitmap& ChunkWorld::Chunk(int32_t cx, int32_t cy)
+{
+    const uint64_t key = Key(cx, cy);
+    if (auto it = table.find(key); it != table.end())
+    {
+        lru.splice(lru.begin(), lru, it->second);
+        lastKey = key;
+        last = &it->second->walls;
+        return *last;
+    }
+
+    lru.push_front({ key, {} });
+    MazeBuilder::BuildChunk(seed, cx, cy, options.chunkRooms, options.generator, lru.front().walls);
+    table.emplace(key, lru.begin());
+    bytes += EntryBytes(lru.front());
+    ++generated;
+
+    // 新块在最前，淘汰从最后开始，至少留下它自己
+    while (bytes > options.memoryCap && lru.size() > 1)
+    {
+        bytes -= EntryBytes(lru.back());
+        table.erase(lru.back().key);
+        lru.pop_back();
+    }
+
+    lastKey = key;
+    last = &lru.front().walls;
+    return *last;
+}
+
+bool ChunkWorld::IsWall(int64_t x, int64_t y)
+{
+    if (!Contains(x, y))
+        throw std::out_of_range("ChunkWorld::IsWall: (" + std::to_string(x) + ", " + std::to_string(y) + ") is outside the world");
+
+    const int32_t cx = (int32_t)ChunkOf(x);
+    const int32_t cy = (int32_t)ChunkOf(y);
+    const WallBitmap& c = (last && lastKey == Key(cx, cy)) ? *last : Chunk(cx, cy);
+    return c.Test((int32_t)(x - (int64_t)cx * side), (int32_t)(y - (int64_t)cy * side));
+}
+
+Maze ChunkWorld::Region(int64_t x0, int64_t y0, int32_t w, int32_t h)
+{
+    Maze maze;
+    maze.seed = seed;
+    maze.generator = options.generator;
+    maze.Resize(std::max(0, w), std::max(0, h), true);
+    if (maze.Empty()) return maze;
+
+    // 先查两个对角再算 x0 + w：在范围内的坐标离 int64 的边界很远，不会溢出
+    if (!Contains(x0, y0) || !Contains(x0 + (w - 1), y0 + (h - 1)))
+        throw std::out_of_range("ChunkWorld::Region: (" + std::to_string(x0) + ", " + std::to_string(y0) + ") + " +
+                                std::to_string(w) + "x" + std::to_string(h) + " is outside the world");
+
+    const int64_t x1 = x0 + w;
+    const int64_t y1 = y0 + h;
+
+    // 块号用 int64 循环：最后一块是 INT32_MAX 时 ++ 不溢出
+    for (int64_t cy = ChunkOf(y0); cy <= ChunkOf(y1 - 1); ++cy)
+    {
+        for (int64_t cx = ChunkOf(x0); cx <= ChunkOf(x1 - 1); ++cx)
+        {
+            const WallBitmap& c = Chunk((int32_t)cx, (int32_t)cy);
+            const int64_t ox = (int64_t)cx * side;
+            const int64_t oy = (int64_t)cy * side;
+
+            // 块与区域的交集，块内坐标
+            const int32_t lx0 = (int32_t)(std::max(x0, ox) - ox);
+            const int32_t lx1 = (int32_t)(std::min(x1, ox + side) - ox);
+            const int32_t ly0 = (int32_t)(std::max(y0, oy) - oy);
+            const int32_t ly1 = (int32_t)(std::min(y1, oy + side) - oy);
+
+            for (int32_t ly = ly0; ly < ly1; ++ly)
+                for (int32_t lx = lx0; lx < lx1; lx += (int32_t)WallBitmap::WordBits)
+                {
+                    const uint32_t n = (uint32_t)std::min<int32_t>(lx1 - lx, (int32_t)WallBitmap::WordBits);
+                    PutBits(maze.walls, (int32_t)(ox + lx - x0), (int32_t)(oy + ly - y0), c.Segment(lx, ly), n);
+                }
+        }
+    }
+    return maze;
+}
+
+void ChunkWorld::Clear()
+{
+    lru.clear();
+    table.clear();
+    bytes = 0;
+    last = nullptr;
+}
@@ -0,0 +1,108 @@
+#include "core/JunctionGraph.hpp"
+
+int JunctionGraph::Degree(size_t cell) const
+{
+    int d = 0;
+    for (int k = 0; k < 4; ++k)
+        d += grid.cells[cell + grid.offsets[k]] == PaddedGrid::Open;
+    return d;
+}
+
+uint32_t JunctionGraph::NodeOf(size_t cell) const
+{
+    const auto it = std::lower_bound(nodeCells.begin(), nodeCells.end(), cell);
+    return (it != nodeCells.end() && *it == cell) ? (uint32_t)(it - nodeCells.begin()) : NoNode;
+}
+
+size_t JunctionGraph::MemoryBytes() const
+{
+    return grid.cells.capacity()
+         + nodeBits.capacity() * sizeof(uint64_t)
+         + nodeCells.capacity() * sizeof(size_t)
+         + offsets.capacity() * sizeof(uint32_t)
+         + targets.capacity() * sizeof(uint32_t)
+         + weights.capacity() * sizeof(int32_t)
+         + dirs.capacity();
+}
+
+// 按节点顺序从每个节点的每个通的方向走到下一个节点，直接写成 CSR；走过的走廊格记在 walked
+void JunctionGraph::EmitEdges(std::vector<uint64_t>& walked)
+{
+    offsets.clear();
+    targets.clear();
+    weights.clear();
+    dirs.clear();
+    offsets.reserve(nodeCells.size() + 1);
+
+    for (const size_t u : nodeCells)
+    {
+        offsets.push_back((uint32_t)targets.size());
+        for (int d = 0; d < 4; ++d)
+        {
+            if (grid.cells[u + grid.offsets[d]] != PaddedGrid::Open) continue;
+
+            int32_t steps = 0;
+            int lastDir = 0;
+            const size_t v = Follow(u, d, NoCell, steps, lastDir, [&](size_t cell) {
+                walked[cell / 64] |= 1ull << (cell % 64);
+            });
+
+            targets.push_back(NodeOf(v));
+            weights.push_back(steps);
+            dirs.push_back((uint8_t)d);
+        }
+    }
+    offsets.push_back((uint32_t)targets.size());
+}
+
+void JunctionGraph::Build(MazeView maze)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+
+    grid.Assign(maze);
+    const size_t words = (grid.Size() + 63) / 64;
+    nodeBits.assign(words, 0);
+    nodeCells.clear();
+
+    for (int32_t y = 0; y < maze.height; ++y)
+        for (int32_t x = 0; x < maze.width; ++x)
+        {
+            const size_t c = grid.Index(x, y);
+            if (grid.cells[c] == PaddedGrid::Open && Degree(c) != 2)
+            {
+                MarkNode(c);
+                nodeCells.push_back(c);
+            }
+        }
+
+    std::vector<uint64_t> walked(words, 0);
+    EmitEdges(walked);
+
+    // 没被任何走廊走到的度数 2 格子在无节点的环上：每个环补一个节点，再按新节点集重出一遍边
+    const size_t before = nodeCells.size();
+    for (int32_t y = 0; y < maze.height; ++y)
+        for (int32_t x = 0; x < maze.width; ++x)
+        {
+            const size_t c = grid.Index(x, y);
+            if (grid.cells[c] != PaddedGrid::Open || IsNode(c) || ((walked[c / 64] >> (c % 64)) & 1ull)) continue;
+
+            MarkNode(c);
+            nodeCells.push_back(c);
+
+            int d = 0;
+            while (grid.cells[c + grid.offsets[d]] != PaddedGrid::Open) ++d;
+            int32_t steps = 0;
+            int lastDir = 0;
+            Follow(c, d, c, steps, lastDir, [&](size_t cell) {
+                walked[cell / 64] |= 1ull << (cell % 64);
+            });
+        }
+
+    if (nodeCells.size() != before)
+    {
+        std::sort(nodeCells.begin(), nodeCells.end());
+        EmitEdges(walked);
+    }
+
+    buildTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0);
+}
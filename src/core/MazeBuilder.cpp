@@ -1,100 +1,1225 @@
 #include "core/MazeBuilder.hpp"
+#include "core/Random.hpp"
+#include "core/WordRows.hpp"
 #include <vector>
-#include <random>
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <bit>
+#include <atomic>
+#include <thread>
 
-Maze MazeBuilder::Build(int seed)
+namespace
 {
-    const int32_t SIZE = 41;
+    // 生成用的顺序随机流：种子相同则在任何平台上逐位一致
+    using Rng = Xoshiro256;
 
-    Maze maze;
-    maze.seed = seed;
-    maze.grid.assign(SIZE, std::vector<int32_t>(SIZE, 1));
+    Rng SeedRng(int seed) {
+        return Rng((uint64_t)(uint32_t)seed);
+    }
 
-    std::mt19937 rng(seed);
+    // 生成器只通过 Carver 操作房间（房间坐标 rx, ry）：
+    //   Visited(rx, ry)   房间是否已连入迷宫
+    //   Visit(rx, ry)     把起始房间连入迷宫
+    //   Open(rx, ry, dir) 打通 (rx, ry) 朝 dir 的墙，两侧房间都算已连入
+    //   IsOpen(rx, ry, dir) 该墙是否已通（打环时用）
+    // 同一份生成代码既能写墙体位图（Build），也能写通道掩码（BuildPassages），随机数消耗完全一致
+
+    // 写 WallBitmap：房间 (rx, ry) 在格子 (2rx+1, 2ry+1)，墙缝在两者之间
+    struct WallCarver
+    {
+        WallBitmap& walls;
+        int32_t roomsW, roomsH;
 
-    auto inBounds = [&](int x, int y) {
-        return x > 0 && y > 0 && x < SIZE - 1 && y < SIZE - 1;
+        bool Visited(int32_t rx, int32_t ry) const { return !walls.Test(rx * 2 + 1, ry * 2 + 1); }
+        void Visit(int32_t rx, int32_t ry)         { walls.Clear(rx * 2 + 1, ry * 2 + 1); }
+
+        void Open(int32_t rx, int32_t ry, int dir) {
+            const int32_t x = rx * 2 + 1;
+            const int32_t y = ry * 2 + 1;
+            walls.Clear(x, y);
+            walls.Clear(x + PassageGrid::DirX[dir], y + PassageGrid::DirY[dir]);
+            walls.Clear(x + PassageGrid::DirX[dir] * 2, y + PassageGrid::DirY[dir] * 2);
+        }
+
+        bool IsOpen(int32_t rx, int32_t ry, int dir) const {
+            return !walls.Test(rx * 2 + 1 + PassageGrid::DirX[dir], ry * 2 + 1 + PassageGrid::DirY[dir]);
+        }
     };
 
-    auto carve = [&](int x, int y) {
-        maze.grid[y][x] = 0;
+    // 写 PassageGrid：有任何通道的房间即已连入，只需单独记住起始房间
+    struct PassageCarver
+    {
+        PassageGrid& g;
+        int32_t roomsW, roomsH;
+        size_t root = 0;
+
+        bool Visited(int32_t rx, int32_t ry) const {
+            const size_t r = g.Room(rx, ry);
+            return r == root || g.Mask(r) != 0;
+        }
+        void Visit(int32_t rx, int32_t ry)         { root = g.Room(rx, ry); }
+        void Open(int32_t rx, int32_t ry, int dir) { g.Open(rx, ry, dir); }
+        bool IsOpen(int32_t rx, int32_t ry, int dir) const { return g.Mask(g.Room(rx, ry)) & (1u << dir); }
+    };
+
+    // 无栈回溯用的树形 Carver，在 Carver 之外再提供：
+    //   Link(rx, ry, dir) 从 (rx, ry) 打通到 dir 侧的新房间，并在新房间里记下回父房间的方向
+    //   Parent(rx, ry)    回父房间的方向（2 位）
+    //   Seal()            生成结束后把暂存的方向还原成正常的墙 / 通道
+    // 回溯只靠房间里的父方向，不需要单独的栈，生成内存就是网格本身
+    // 方向 0..3 = E W S N，反方向是 dir ^ 1
+
+    // 位图版：生成期间房间格和它东南角的柱子（两者最终分别是通道和墙）暂存父方向的两位，
+    // 是否已连入由这两位加北墙缝判定（起始房间单独记）
+    struct WallTreeCarver
+    {
+        WallBitmap& walls;
+        int32_t roomsW, roomsH;
+        uint64_t* data = walls.Data();
+
+        bool Bit(int32_t x, int32_t y) const {
+            const size_t b = walls.BitIndex(x, y);
+            return (data[b / WallBitmap::WordBits] >> (b % WallBitmap::WordBits)) & 1ull;
+        }
+        void Put(int32_t x, int32_t y, bool v) {
+            const size_t b = walls.BitIndex(x, y);
+            const uint64_t m = 1ull << (b % WallBitmap::WordBits);
+            data[b / WallBitmap::WordBits] = v ? (data[b / WallBitmap::WordBits] | m) : (data[b / WallBitmap::WordBits] & ~m);
+        }
+
+        // 未连入的房间：两位都还是墙（读出来同父方向 N），且北墙缝未通；三次读互不依赖，按位合并不分支
+        bool Visited(int32_t rx, int32_t ry) const {
+            const int32_t x = rx * 2 + 1;
+            const int32_t y = ry * 2 + 1;
+            return ((rx | ry) == 0) | !(Bit(x, y) & Bit(x + 1, y + 1) & Bit(x, y - 1));
+        }
+
+        void Link(int32_t rx, int32_t ry, int dir) {
+            const int32_t x = rx * 2 + 1 + PassageGrid::DirX[dir];
+            const int32_t y = ry * 2 + 1 + PassageGrid::DirY[dir];
+            Put(x, y, false);
+
+            const int back = dir ^ 1;
+            const int32_t nx = x + PassageGrid::DirX[dir];
+            const int32_t ny = y + PassageGrid::DirY[dir];
+            Put(nx, ny, back & 1);
+            Put(nx + 1, ny + 1, back & 2);
+        }
+
+        int Parent(int32_t rx, int32_t ry) const {
+            const int32_t x = rx * 2 + 1;
+            const int32_t y = ry * 2 + 1;
+            return (int)Bit(x, y) | ((int)Bit(x + 1, y + 1) << 1);
+        }
+
+        void Seal() {
+            for (int32_t ry = 0; ry < roomsH; ++ry)
+                for (int32_t rx = 0; rx < roomsW; ++rx)
+                {
+                    Put(rx * 2 + 1, ry * 2 + 1, false);
+                    Put(rx * 2 + 2, ry * 2 + 2, true);
+                }
+        }
     };
 
-    // start
-    carve(1, 1);
+    // 掩码版：生成期间每条边只写在子房间一侧，于是房间的掩码恰好只有指向父房间的一位；
+    // Seal() 再把所有边补成双向（按位或，与处理顺序无关）
+    struct PassageTreeCarver
+    {
+        PassageGrid& g;
+        int32_t roomsW, roomsH;
+
+        bool Visited(int32_t rx, int32_t ry) const {
+            const size_t r = g.Room(rx, ry);
+            return r == 0 || g.Mask(r) != 0;
+        }
+
+        void Link(int32_t rx, int32_t ry, int dir) {
+            g.AddMask(g.Room(rx + PassageGrid::DirX[dir], ry + PassageGrid::DirY[dir]), (uint8_t)(1u << (dir ^ 1)));
+        }
+
+        int Parent(int32_t rx, int32_t ry) const {
+            return std::countr_zero((unsigned)g.Mask(g.Room(rx, ry)));
+        }
+
+        void Seal() {
+            const ptrdiff_t step[4] = { 1, -1, roomsW, -(ptrdiff_t)roomsW };
+            for (size_t r = 0; r < g.RoomCount(); ++r)
+                for (uint32_t m = g.Mask(r); m != 0; m &= m - 1)
+                {
+                    const int dir = std::countr_zero(m);
+                    g.AddMask((size_t)((ptrdiff_t)r + step[dir]), (uint8_t)(1u << (dir ^ 1)));
+                }
+        }
+    };
+
+    WallTreeCarver TreeOf(WallCarver& c)       { return { c.walls, c.roomsW, c.roomsH }; }
+    PassageTreeCarver TreeOf(PassageCarver& c) { return { c.g, c.roomsW, c.roomsH }; }
+
+    int Coin(Rng& rng) {
+        return (int)(rng.Next64() >> 63);
+    }
+
+    template <class Carver>
+    bool HasNeighbour(const Carver& c, int32_t rx, int32_t ry, int dir) {
+        const int32_t nx = rx + PassageGrid::DirX[dir];
+        const int32_t ny = ry + PassageGrid::DirY[dir];
+        return nx >= 0 && ny >= 0 && nx < c.roomsW && ny < c.roomsH;
+    }
+
+    // 随机 DFS 回溯，从房间 (0, 0) 出发。无栈：进入新房间时记下父方向，无路可走时照着退回，
+    // 退回起始房间即结束。c 为树形 Carver
+    // 每步在未连入的邻居里等概率选一个（与“随机排列后取第一个可走方向”同分布），
+    // 只有两个以上候选时才消耗一次随机数，死路和回溯不再洗牌
+    template <class TreeCarver>
+    void CarveBacktracker(TreeCarver& c, Rng& rng)
+    {
+        Point cur{ 0, 0 };
+
+        // Perfect maze (unique path)
+        while (true)
+        {
+            // 可走方向的位掩码；越界的方向拿当前房间代查（必为已连入），避免分支
+            uint32_t open = 0;
+            for (int dir = 0; dir < 4; ++dir)
+            {
+                const bool inside = HasNeighbour(c, cur.x, cur.y, dir);
+                const int32_t nx = inside ? cur.x + PassageGrid::DirX[dir] : cur.x;
+                const int32_t ny = inside ? cur.y + PassageGrid::DirY[dir] : cur.y;
+                open |= (uint32_t)!c.Visited(nx, ny) << dir; // only carve into unvisited
+            }
+
+            if (open != 0)
+            {
+                const int n = std::popcount(open);
+                for (int k = (n == 1) ? 0 : (int)UniformBelow(rng, (uint64_t)n); k > 0; --k)
+                    open &= open - 1;
+
+                const int dir = std::countr_zero(open);
+                c.Link(cur.x, cur.y, dir);
+                cur = { cur.x + PassageGrid::DirX[dir], cur.y + PassageGrid::DirY[dir] };
+                continue;
+            }
+            if (cur.x == 0 && cur.y == 0) break;
+
+            const int back = c.Parent(cur.x, cur.y);
+            cur = { cur.x + PassageGrid::DirX[back], cur.y + PassageGrid::DirY[back] };
+        }
+
+        c.Seal();
+    }
+
+    // Kruskal：所有内部边随机排序，端点不连通就打通；并查集按秩合并 + 路径减半
+    template <class Carver>
+    void CarveKruskal(Carver& c, Rng& rng)
+    {
+        const size_t rooms = (size_t)c.roomsW * (size_t)c.roomsH;
+
+        // 边编码：room * 2 + (0 = 东, 1 = 南)
+        std::vector<uint64_t> edges;
+        edges.reserve(rooms * 2);
+        for (int32_t ry = 0; ry < c.roomsH; ++ry)
+        {
+            for (int32_t rx = 0; rx < c.roomsW; ++rx)
+            {
+                const uint64_t r = (uint64_t)ry * (uint64_t)c.roomsW + (uint64_t)rx;
+                if (rx + 1 < c.roomsW) edges.push_back(r * 2);
+                if (ry + 1 < c.roomsH) edges.push_back(r * 2 + 1);
+            }
+        }
+        Shuffle(edges.begin(), edges.end(), rng);
+
+        std::vector<uint32_t> parent(rooms);
+        std::vector<uint8_t> rank(rooms, 0);
+        for (size_t i = 0; i < rooms; ++i) parent[i] = (uint32_t)i;
+
+        auto find = [&](uint32_t x) {
+            while (parent[x] != x)
+            {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        };
+
+        size_t joined = 1;
+        for (const uint64_t e : edges)
+        {
+            if (joined == rooms) break;
+
+            const uint64_t r = e / 2;
+            const uint64_t n = (e & 1) ? r + (uint64_t)c.roomsW : r + 1;
+
+            uint32_t a = find((uint32_t)r);
+            uint32_t b = find((uint32_t)n);
+            if (a == b) continue;
+
+            if (rank[a] < rank[b]) std::swap(a, b);
+            parent[b] = a;
+            if (rank[a] == rank[b]) ++rank[a];
+
+            c.Open((int32_t)(r % (uint64_t)c.roomsW), (int32_t)(r / (uint64_t)c.roomsW), (e & 1) ? 2 : 0);
+            ++joined;
+        }
+    }
+
+    // Prim：从前沿边中随机取一条，另一端未连入就打通，并把它的边加入前沿
+    template <class Carver>
+    void CarvePrim(Carver& c, Rng& rng)
+    {
+        // 前沿边编码：room * 4 + dir
+        std::vector<uint64_t> frontier;
 
-    // step=2 grid (cells at odd coords)
-    const int dx[4] = { 2, -2, 0, 0 };
-    const int dy[4] = { 0, 0, 2, -2 };
+        auto addEdges = [&](int32_t rx, int32_t ry) {
+            const uint64_t r = (uint64_t)ry * (uint64_t)c.roomsW + (uint64_t)rx;
+            for (int dir = 0; dir < 4; ++dir)
+            {
+                if (!HasNeighbour(c, rx, ry, dir)) continue;
+                if (c.Visited(rx + PassageGrid::DirX[dir], ry + PassageGrid::DirY[dir])) continue;
+                frontier.push_back(r * 4 + (uint64_t)dir);
+            }
+        };
+
+        addEdges(0, 0);
+        while (!frontier.empty())
+        {
+            const size_t i = (size_t)UniformBelow(rng, frontier.size());
+            const uint64_t e = frontier[i];
+            frontier[i] = frontier.back();
+            frontier.pop_back();
 
-    std::vector<Point> st;
-    st.push_back({ 1, 1});
+            const uint64_t r = e / 4;
+            const int dir = (int)(e % 4);
+            const int32_t rx = (int32_t)(r % (uint64_t)c.roomsW);
+            const int32_t ry = (int32_t)(r / (uint64_t)c.roomsW);
+            const int32_t nx = rx + PassageGrid::DirX[dir];
+            const int32_t ny = ry + PassageGrid::DirY[dir];
+            if (c.Visited(nx, ny)) continue;
 
-    // Perfect maze (unique path)
-    while (!st.empty())
+            c.Open(rx, ry, dir);
+            addEdges(nx, ny);
+        }
+    }
+
+    // Wilson：从每个未连入的房间随机游走到已连入区域，只保留最后一次离开各房间的方向（即擦掉回路），
+    // 再沿记录的方向打通。得到的是所有生成树上的均匀分布
+    template <class Carver>
+    void CarveWilson(Carver& c, Rng& rng)
     {
-        Point cur = st.back();
+        std::vector<uint8_t> exitDir((size_t)c.roomsW * (size_t)c.roomsH, 0);
+        auto pick = [](Rng& r) { return (int)(r.Next64() >> 62); };   // 高两位直接当方向
 
-        std::array<int, 4> dirs = { 0, 1, 2, 3 };
-        std::shuffle(dirs.begin(), dirs.end(), rng);
+        for (int32_t ry = 0; ry < c.roomsH; ++ry)
+        {
+            for (int32_t rx = 0; rx < c.roomsW; ++rx)
+            {
+                if (c.Visited(rx, ry)) continue;
 
-        bool moved = false;
-        for (int dir : dirs)
+                Point cur{ rx, ry };
+                while (!c.Visited(cur.x, cur.y))
+                {
+                    int dir = pick(rng);
+                    while (!HasNeighbour(c, cur.x, cur.y, dir)) dir = pick(rng);
+
+                    exitDir[(size_t)cur.y * (size_t)c.roomsW + (size_t)cur.x] = (uint8_t)dir;
+                    cur = { cur.x + PassageGrid::DirX[dir], cur.y + PassageGrid::DirY[dir] };
+                }
+
+                // Open() 会把下一个房间标成已连入，所以按终点判断何时停止
+                const Point end = cur;
+                cur = { rx, ry };
+                while (!(cur == end))
+                {
+                    const int dir = exitDir[(size_t)cur.y * (size_t)c.roomsW + (size_t)cur.x];
+                    c.Open(cur.x, cur.y, dir);
+                    cur = { cur.x + PassageGrid::DirX[dir], cur.y + PassageGrid::DirY[dir] };
+                }
+            }
+        }
+    }
+
+    // Hunt-and-Kill：随机游走到走不动，然后逐行找一个挨着已连入区域的未连入房间接着走
+    template <class Carver>
+    void CarveHuntAndKill(Carver& c, Rng& rng)
+    {
+        Point cur{ 0, 0 };
+        int32_t huntRow = 0;   // 之前的行都已连入
+
+        std::array<int, 4> options{};
+        while (true)
         {
-            const int nx = cur.x + dx[dir];
-            const int ny = cur.y + dy[dir];
+            int n = 0;
+            for (int dir = 0; dir < 4; ++dir)
+                if (HasNeighbour(c, cur.x, cur.y, dir)
+                    && !c.Visited(cur.x + PassageGrid::DirX[dir], cur.y + PassageGrid::DirY[dir]))
+                    options[n++] = dir;
+
+            if (n > 0)
+            {
+                const int dir = options[UniformBelow(rng, (uint64_t)n)];
+                c.Open(cur.x, cur.y, dir);
+                cur = { cur.x + PassageGrid::DirX[dir], cur.y + PassageGrid::DirY[dir] };
+                continue;
+            }
 
-            if (!inBounds(nx, ny)) continue;
-            if (maze.grid[ny][nx] != 1) continue; // only carve into unvisited
+            // hunt
+            bool found = false;
+            for (int32_t ry = huntRow; ry < c.roomsH && !found; ++ry)
+            {
+                bool rowDone = true;
+                for (int32_t rx = 0; rx < c.roomsW; ++rx)
+                {
+                    if (c.Visited(rx, ry)) continue;
+                    rowDone = false;
 
-            carve(cur.x + dx[dir] / 2, cur.y + dy[dir] / 2);
-            carve(nx, ny);
+                    n = 0;
+                    for (int dir = 0; dir < 4; ++dir)
+                        if (HasNeighbour(c, rx, ry, dir)
+                            && c.Visited(rx + PassageGrid::DirX[dir], ry + PassageGrid::DirY[dir]))
+                            options[n++] = dir;
+                    if (n == 0) continue;
 
-            st.push_back({ (int32_t)nx, (int32_t)ny});
-            moved = true;
-            break; // fewer branches
+                    const int dir = options[UniformBelow(rng, (uint64_t)n)];
+                    c.Open(rx, ry, dir);
+                    cur = { rx, ry };
+                    found = true;
+                    break;
+                }
+                if (rowDone && ry == huntRow) ++huntRow;
+            }
+            if (!found) break;
         }
+    }
 
-        if (!moved)
-            st.pop_back();
+    // Binary Tree：每个房间独立地向北或向西打通（边界上只有一种选择）
+    template <class Carver>
+    void CarveBinaryTree(Carver& c, Rng& rng)
+    {
+        for (int32_t ry = 0; ry < c.roomsH; ++ry)
+        {
+            for (int32_t rx = 0; rx < c.roomsW; ++rx)
+            {
+                if (rx == 0 && ry == 0) continue;
+                if (ry == 0)      c.Open(rx, ry, 1);
+                else if (rx == 0) c.Open(rx, ry, 3);
+                else              c.Open(rx, ry, Coin(rng) ? 3 : 1);
+            }
+        }
     }
 
-    // +++ add: braid ~10 walls to create ~multiple routes (cycles)
-    // This increases the number of distinct paths from (1,1) to (SIZE-2,SIZE-2).
-    constexpr int EXTRA_LOOPS = 10;
+    // Sidewinder：首行整行打通；其余各行向东延伸一段，段结束时从段中随机一个房间向北打通
+    template <class Carver>
+    void CarveSidewinder(Carver& c, Rng& rng)
+    {
+        for (int32_t rx = 0; rx + 1 < c.roomsW; ++rx)
+            c.Open(rx, 0, 0);
 
-    struct WallCell { int x; int y; };
-    std::vector<WallCell> candidates;
-    candidates.reserve((size_t)SIZE * (size_t)SIZE / 4);
+        for (int32_t ry = 1; ry < c.roomsH; ++ry)
+        {
+            int32_t runStart = 0;
+            for (int32_t rx = 0; rx < c.roomsW; ++rx)
+            {
+                const bool closeRun = (rx + 1 == c.roomsW) || Coin(rng);
+                if (closeRun)
+                {
+                    const int32_t k = UniformInt(rng, runStart, rx);
+                    c.Open(k, ry, 3);
+                    runStart = rx + 1;
+                }
+                else
+                {
+                    c.Open(rx, ry, 0);
+                }
+            }
+        }
+    }
 
-    for (int y = 1; y < SIZE - 1; ++y)
+    // 整字版 Binary Tree / Sidewinder 的逐房间接口：按行生成掩码后逐位交给 Carver（分块、BuildPassages 用）
+    template <class Carver>
+    void CarveWordRows(Carver& c, WordRows::Kind kind, Rng& rng)
     {
-        for (int x = 1; x < SIZE - 1; ++x)
+        WordRows rows(kind, c.roomsW, rng);
+        for (int32_t ry = 0; ry < c.roomsH; ++ry)
         {
-            if (maze.grid[y][x] != 1) continue;
+            rows.Next();
+            for (size_t j = 0; j < rows.North().size(); ++j)
+            {
+                for (uint64_t m = rows.North()[j]; m != 0; m &= m - 1)
+                    c.Open((int32_t)(j * 64) + std::countr_zero(m), ry, 3);
+                for (uint64_t m = rows.East()[j]; m != 0; m &= m - 1)
+                    c.Open((int32_t)(j * 64) + std::countr_zero(m), ry, 0);
+            }
+        }
+    }
 
-            // wall between two corridors (either horizontal or vertical)
-            const bool horiz = (maze.grid[y][x - 1] == 0 && maze.grid[y][x + 1] == 0);
-            const bool vert  = (maze.grid[y - 1][x] == 0 && maze.grid[y + 1][x] == 0);
-            if (horiz || vert)
-                candidates.push_back({ x, y });
+    // 整字版直接写位图：每个房间行展开成两条网格行整字写入，不经过逐房间的 Carver
+    void WriteWordRows(WallBitmap& walls, WordRows::Kind kind, Rng& rng)
+    {
+        WordRows rows(kind, (walls.width - 1) / 2, rng);
+        std::vector<uint64_t> gapRow(rows.RowWords()), roomRow(rows.RowWords());
+        for (int32_t ry = 0; ry < (walls.height - 1) / 2; ++ry)
+        {
+            rows.Next();
+            rows.Expand(gapRow, roomRow);
+            walls.StoreRow(ry * 2, gapRow);
+            walls.StoreRow(ry * 2 + 1, roomRow);
         }
     }
 
-    std::shuffle(candidates.begin(), candidates.end(), rng);
+    // Eller：一次处理一个房间行，只记住本行每个房间所属的集合
+    //   1. 没有从上一行继承集合的房间分配新编号
+    //   2. 相邻且不同集合的房间随机向东打通并合并（最后一行全部合并）
+    //   3. 每个集合至少一个房间向南打通，向南的房间把编号带到下一行
+    // 编号取自 [0, roomsW)：一行里的集合数不超过房间数，总有空闲编号
+    // 空闲编号随合并回收：每个集合都会有房间向南，只有被并掉的编号会离开下一行
+    // 向东 / 向南按位存（每字 64 个房间，布局同 WordRows，可直接 ExpandRow）；逐房间的循环里不按硬币分支，
+    // 随机位的消耗顺序与逐个抛硬币相同
+    class EllerRows
+    {
+    public:
+        explicit EllerRows(int32_t roomsW)
+            : roomsW(roomsW), label(roomsW), parent(roomsW), lastRoom(roomsW), downRow(roomsW, 0),
+              freeLabels(roomsW + 1) {
+            // freeLabels[1..freeCount] 为空闲编号，栈顶在 freeCount；多留一格，无分支压栈时写 [freeCount + 1] 不越界
+            for (int32_t i = 0; i < roomsW; ++i)
+                freeLabels[(size_t)i + 1] = (uint32_t)(roomsW - 1 - i);
+            freeCount = (uint32_t)roomsW;
+
+            const size_t words = WordRows::RoomWords(roomsW);
+            valid.assign(words, 0);
+            east.assign(words, 0);
+            west.assign(words, 0);
+            south.assign(words, 0);
+            for (int32_t rx = 0; rx < roomsW; rx += 64)
+            {
+                const int32_t n = std::min(roomsW - rx, 64);
+                valid[(size_t)rx / 64] = (n == 64) ? ~0ull : ((1ull << n) - 1);
+            }
+        }
+
+        // 生成下一行
+        void Next(Rng& rng, bool lastRow) {
+            const size_t n = ((size_t)roomsW + 63) / 64;
+
+            // 1. 新编号：上一行没有向南的房间（首行 south 全 0）
+            for (size_t j = 0; j < n; ++j)
+                for (uint64_t m = valid[j] & ~south[j]; m; m &= m - 1)
+                    label[j * 64 + (size_t)std::countr_zero(m)] = freeLabels[freeCount--];
 
-    int opened = 0;
-    for (const auto& w : candidates)
+            // 2. 横向合并（编号上的并查集，行末压平）；a 是左邻所在集合的根，随 x 右移带着走
+            for (int32_t l = 0; l < roomsW; ++l) parent[l] = (uint32_t)l;
+            std::fill(east.begin(), east.end(), 0);
+            uint32_t a = label[0];
+            for (int32_t x = 0; x + 1 < roomsW; ++x)
+            {
+                const uint32_t b = Find(label[x + 1]);
+                const uint32_t differ = a != b;
+                uint32_t open = differ;
+                if (!lastRow)
+                {
+                    // 只有两侧不同集合时才抛硬币
+                    if (differ && coinBits == 0) { coinWord = rng.Next64(); coinBits = 64; }
+                    open = differ & (uint32_t)(coinWord & 1u);
+                    coinWord >>= differ;
+                    coinBits -= (int32_t)differ;
+                }
+
+                east[(size_t)x / 64] |= (uint64_t)open << (x % 64);
+                parent[b] = open ? a : b;
+                freeLabels[freeCount + 1] = b;
+                freeCount += open;
+                a = open ? a : b;
+            }
+            for (int32_t x = 0; x < roomsW; ++x)
+                label[x] = Find(label[x]);
+
+            for (size_t j = 0; j < n; ++j)
+                west[j] = (east[j] << 1) | ((j > 0) ? (east[j - 1] >> 63) : 0);
+
+            // 3. 向南：每个房间一枚硬币（整字取出），集合里一枚正面都没有的，最后一个房间补一个
+            if (lastRow)
+            {
+                std::fill(south.begin(), south.end(), 0);
+                return;
+            }
+            for (size_t j = 0; j < n; ++j)
+                south[j] = Coins(rng, std::min<int32_t>(64, roomsW - (int32_t)j * 64));
+
+            // downRow[l] 记下集合 l 最近一次有正面的行号，省去逐行清零
+            ++row;
+            for (int32_t x = 0; x < roomsW; ++x)
+            {
+                const uint32_t l = label[x];
+                lastRoom[l] = (uint32_t)x;
+                downRow[l] = ((south[(size_t)x / 64] >> (x % 64)) & 1u) ? row : downRow[l];
+            }
+            for (int32_t x = 0; x < roomsW; ++x)
+            {
+                const uint32_t l = label[x];
+                const uint64_t forced = (lastRoom[l] == (uint32_t)x) & (downRow[l] != row);
+                south[(size_t)x / 64] |= forced << (x % 64);
+            }
+        }
+
+        bool East(int32_t rx) const  { return (east[(size_t)rx / 64] >> (rx % 64)) & 1u; }
+        bool South(int32_t rx) const { return (south[(size_t)rx / 64] >> (rx % 64)) & 1u; }
+
+        // 整字视图：bit i = 房间 i，布局同 WordRows，长度 WordRows::RoomWords(roomsW)
+        std::span<const uint64_t> Valid() const { return valid; }
+        std::span<const uint64_t> West() const  { return west; }
+        std::span<const uint64_t> South() const { return south; }
+
+    private:
+        uint32_t Find(uint32_t x) {
+            while (parent[x] != x)
+            {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        }
+
+        // 接下来的 count 枚硬币（count <= 64），第 i 枚在第 i 位
+        uint64_t Coins(Rng& rng, int32_t count) {
+            uint64_t out = 0;
+            for (int32_t got = 0; got < count; )
+            {
+                if (coinBits == 0) { coinWord = rng.Next64(); coinBits = 64; }
+                const int32_t k = std::min(count - got, coinBits);
+                const uint64_t part = (k == 64) ? coinWord : (coinWord & ((1ull << k) - 1));
+                out |= part << got;
+                coinWord = (k == 64) ? 0 : (coinWord >> k);
+                coinBits -= k;
+                got += k;
+            }
+            return out;
+        }
+
+        int32_t roomsW;
+        uint64_t coinWord = 0;
+        int32_t coinBits = 0;
+        uint32_t freeCount = 0;
+        uint32_t row = 0;
+        std::vector<uint32_t> label, parent, lastRoom, downRow, freeLabels;
+        std::vector<uint64_t> valid, east, west, south;
+    };
+
+    template <class Carver>
+    void CarveEller(Carver& c, Rng& rng)
     {
-        if (opened >= EXTRA_LOOPS) break;
-        if (maze.grid[w.y][w.x] == 1)
+        EllerRows rows(c.roomsW);
+        for (int32_t ry = 0; ry < c.roomsH; ++ry)
         {
-            carve(w.x, w.y);
-            ++opened;
+            rows.Next(rng, ry + 1 == c.roomsH);
+            for (int32_t rx = 0; rx < c.roomsW; ++rx)
+            {
+                if (rows.East(rx))  c.Open(rx, ry, 0);
+                if (rows.South(rx)) c.Open(rx, ry, 2);
+            }
         }
     }
 
+    template <class Carver>
+    void Carve(Carver& c, MazeGenerator generator, Rng& rng)
+    {
+        c.Visit(0, 0);
+
+        switch (generator)
+        {
+        case MazeGenerator::Backtracker: { auto tree = TreeOf(c); CarveBacktracker(tree, rng); break; }
+        case MazeGenerator::Kruskal:     CarveKruskal(c, rng);     break;
+        case MazeGenerator::Prim:        CarvePrim(c, rng);        break;
+        case MazeGenerator::Wilson:      CarveWilson(c, rng);      break;
+        case MazeGenerator::HuntAndKill: CarveHuntAndKill(c, rng); break;
+        case MazeGenerator::BinaryTree:  CarveBinaryTree(c, rng);  break;
+        case MazeGenerator::Sidewinder:  CarveSidewinder(c, rng);  break;
+        case MazeGenerator::Eller:       CarveEller(c, rng);       break;
+        case MazeGenerator::BinaryTreeSimd: CarveWordRows(c, WordRows::Kind::BinaryTree, rng); break;
+        case MazeGenerator::SidewinderSimd: CarveWordRows(c, WordRows::Kind::Sidewinder, rng); break;
+        }
+    }
+
+    struct Gap { int32_t rx; int32_t ry; int dir; };
+
+    size_t WorkerCount(size_t n, int32_t threads)
+    {
+        if (threads <= 0) threads = (int32_t)std::max(1u, std::thread::hardware_concurrency());
+        return std::max<size_t>(1, std::min<size_t>((size_t)threads, n));
+    }
+
+    // 在 WorkerCount(n, threads) 个线程上执行 fn(i, worker)，i = 0..n-1；各下标的结果只取决于下标本身，与调度无关
+    // 同一 worker 的调用都在同一线程上依次执行，可按 worker 复用临时内存
+    void ParallelFor(size_t n, int32_t threads, const std::function<void(size_t, size_t)>& fn)
+    {
+        const size_t workers = WorkerCount(n, threads);
+        if (workers <= 1)
+        {
+            for (size_t i = 0; i < n; ++i) fn(i, 0);
+            return;
+        }
+
+        std::atomic<size_t> next{ 0 };
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (size_t t = 0; t < workers; ++t)
+            pool.emplace_back([&, t] {
+                for (size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1))
+                    fn(i, t);
+            });
+        for (auto& th : pool) th.join();
+    }
+
+    // 只记录走过的边的 Carver：用来在块之间生成一棵生成树
+    struct EdgeCarver
+    {
+        int32_t roomsW, roomsH;
+        std::vector<uint8_t> visited;
+        std::vector<Gap> edges;
+
+        EdgeCarver(int32_t w, int32_t h) : roomsW(w), roomsH(h), visited((size_t)w * (size_t)h, 0) {}
+
+        bool Visited(int32_t rx, int32_t ry) const { return visited[(size_t)ry * (size_t)roomsW + (size_t)rx]; }
+        void Visit(int32_t rx, int32_t ry)         { visited[(size_t)ry * (size_t)roomsW + (size_t)rx] = 1; }
+
+        void Open(int32_t rx, int32_t ry, int dir) {
+            Visit(rx, ry);
+            Visit(rx + PassageGrid::DirX[dir], ry + PassageGrid::DirY[dir]);
+            edges.push_back({ rx, ry, dir });
+        }
+
+        // 树形接口：visited 字节的高位顺带存父方向（起点已连入，只写新房间）
+        void Link(int32_t rx, int32_t ry, int dir) {
+            visited[(size_t)(ry + PassageGrid::DirY[dir]) * (size_t)roomsW + (size_t)(rx + PassageGrid::DirX[dir])] = (uint8_t)(1 | ((dir ^ 1) << 1));
+            edges.push_back({ rx, ry, dir });
+        }
+        int Parent(int32_t rx, int32_t ry) const { return visited[(size_t)ry * (size_t)roomsW + (size_t)rx] >> 1; }
+        void Seal() {}
+    };
+
+    // 分块生成：房间平面切成 tileRooms x tileRooms 的块，每块用 (seed, 块号) 派生的随机流
+    // 独立生成一棵生成树（可并行）；再用主随机流在块之间生成一棵生成树，每条块边在公共边界上随机开一个口。
+    // 树套树仍是完美迷宫，且结果与线程数、调度顺序无关
+    struct TiledRooms
+    {
+        int32_t tileRooms = 0;
+        int32_t tilesX = 0, tilesY = 0;
+        std::vector<PassageGrid> tiles;
+        std::vector<Gap> seams;
+
+        uint8_t Mask(int32_t rx, int32_t ry) const {
+            const PassageGrid& t = tiles[(size_t)(ry / tileRooms) * (size_t)tilesX + (size_t)(rx / tileRooms)];
+            return t.Mask(t.Room(rx % tileRooms, ry % tileRooms));
+        }
+    };
+
+    TiledRooms CarveTiles(int seed, int32_t roomsW, int32_t roomsH, const BuildOptions& options, Rng& rng)
+    {
+        TiledRooms plan;
+        plan.tileRooms = options.tileRooms;
+        plan.tilesX = (roomsW + plan.tileRooms - 1) / plan.tileRooms;
+        plan.tilesY = (roomsH + plan.tileRooms - 1) / plan.tileRooms;
+        plan.tiles.resize((size_t)plan.tilesX * (size_t)plan.tilesY);
+
+        ParallelFor(plan.tiles.size(), options.threads, [&](size_t i, size_t) {
+            const int32_t tx = (int32_t)(i % (size_t)plan.tilesX);
+            const int32_t ty = (int32_t)(i / (size_t)plan.tilesX);
+            const int32_t w = std::min(plan.tileRooms, roomsW - tx * plan.tileRooms);
+            const int32_t h = std::min(plan.tileRooms, roomsH - ty * plan.tileRooms);
+
+            PassageGrid& tile = plan.tiles[i];
+            tile.Resize(w, h);
+
+            // 块的随机流按 (seed, 块号) 从计数器生成器取种，与其他块和线程调度无关
+            Rng tileRng(Philox::At64((uint64_t)(uint32_t)seed, i, 0));
+            PassageCarver carver{ tile, w, h };
+            Carve(carver, options.generator, tileRng);
+        });
+
+        // 块之间的生成树
+        EdgeCarver tileTree(plan.tilesX, plan.tilesY);
+        tileTree.Visit(0, 0);
+        CarveBacktracker(tileTree, rng);
+
+        plan.seams.reserve(tileTree.edges.size());
+        for (const Gap& e : tileTree.edges)
+        {
+            // 把边统一成从西 / 北侧的块出发
+            int32_t tx = e.rx, ty = e.ry;
+            int dir = e.dir;
+            if (dir == 1) { tx -= 1; dir = 0; }
+            if (dir == 3) { ty -= 1; dir = 2; }
+
+            if (dir == 0)
+            {
+                const int32_t y0 = ty * plan.tileRooms;
+                const int32_t y1 = std::min(y0 + plan.tileRooms, roomsH);
+                const int32_t ry = UniformInt(rng, y0, y1 - 1);
+                plan.seams.push_back({ (tx + 1) * plan.tileRooms - 1, ry, 0 });
+            }
+            else
+            {
+                const int32_t x0 = tx * plan.tileRooms;
+                const int32_t x1 = std::min(x0 + plan.tileRooms, roomsW);
+                const int32_t rx = UniformInt(rng, x0, x1 - 1);
+                plan.seams.push_back({ rx, (ty + 1) * plan.tileRooms - 1, 2 });
+            }
+        }
+        return plan;
+    }
+
+    // 把分块结果写进墙体位图：按 64 行一条带并行，每个线程只写自己的行；
+    // 行主序下相邻条带可能共用首尾两个字，这两个字用原子与操作，其余直接写
+    void WriteTiles(const TiledRooms& plan, WallBitmap& walls, int32_t threads)
+    {
+        const int32_t W = walls.width;
+        const int32_t H = walls.height;
+        const int32_t roomsW = (W - 1) / 2;
+        constexpr int32_t BandRows = 64;
+        const size_t bands = ((size_t)H + BandRows - 1) / BandRows;
+
+        ParallelFor(bands, threads, [&](size_t band, size_t) {
+            const int32_t y0 = (int32_t)band * BandRows;
+            const int32_t y1 = std::min(y0 + BandRows, H);
+
+            size_t firstWord = SIZE_MAX, lastWord = SIZE_MAX;
+            if (walls.layout == MazeLayout::RowMajor)
+            {
+                firstWord = walls.BitIndex(0, y0) / WallBitmap::WordBits;
+                lastWord = walls.BitIndex(W - 1, y1 - 1) / WallBitmap::WordBits;
+            }
+
+            uint64_t* data = walls.Data();
+            auto clear = [&](int32_t x, int32_t y) {
+                const size_t bit = walls.BitIndex(x, y);
+                const size_t wi = bit / WallBitmap::WordBits;
+                const uint64_t keep = ~(1ull << (bit % WallBitmap::WordBits));
+                if (wi == firstWord || wi == lastWord)
+                    std::atomic_ref<uint64_t>(data[wi]).fetch_and(keep, std::memory_order_relaxed);
+                else
+                    data[wi] &= keep;
+            };
+
+            for (int32_t y = std::max(y0, 1); y < std::min(y1, H - 1); ++y)
+            {
+                const bool roomRow = (y % 2) == 1;
+                const int32_t ry = roomRow ? y / 2 : y / 2 - 1;
+                for (int32_t rx = 0; rx < roomsW; ++rx)
+                {
+                    const uint8_t m = plan.Mask(rx, ry);
+                    if (roomRow)
+                    {
+                        clear(rx * 2 + 1, y);
+                        if (m & PassageGrid::East) clear(rx * 2 + 2, y);
+                    }
+                    else if (m & PassageGrid::South)
+                    {
+                        clear(rx * 2 + 1, y);
+                    }
+                }
+            }
+        });
+
+        for (const Gap& g : plan.seams)
+            walls.Clear(g.rx * 2 + 1 + PassageGrid::DirX[g.dir], g.ry * 2 + 1 + PassageGrid::DirY[g.dir]);
+    }
+
+    // 打环。房间间墙缝按编号：先是 (roomsW-1)*roomsH 条东墙缝（行主序），再是 roomsW*(roomsH-1) 条南墙缝
+    template <class Carver>
+    uint64_t GapCount(const Carver& c) {
+        return (uint64_t)(c.roomsW - 1) * (uint64_t)c.roomsH + (uint64_t)c.roomsW * (uint64_t)(c.roomsH - 1);
+    }
+
+    template <class Carver>
+    Gap GapAt(const Carver& c, uint64_t i) {
+        const uint64_t eastGaps = (uint64_t)(c.roomsW - 1) * (uint64_t)c.roomsH;
+        if (i < eastGaps)
+            return { (int32_t)(i % (uint64_t)(c.roomsW - 1)), (int32_t)(i / (uint64_t)(c.roomsW - 1)), 0 };
+        i -= eastGaps;
+        return { (int32_t)(i % (uint64_t)c.roomsW), (int32_t)(i / (uint64_t)c.roomsW), 2 };
+    }
+
+    // 在 closed 条关着的墙缝里等概率打通 k 条
+    template <class Carver>
+    void OpenClosedGaps(Carver& c, uint64_t closed, uint64_t k, Rng& rng)
+    {
+        k = std::min(k, closed);
+        if (k == 0) return;
+        const uint64_t total = GapCount(c);
+
+        if (k * 2 <= closed)
+        {
+            // 稀疏：直接按编号在全部墙缝里抽，抽到已通的重抽。关着的约占全部墙缝的一半，
+            // 抽完时也还剩至少一半，每条期望不超过约 4 次抽取，总共 O(k)，不扫描网格
+            for (uint64_t opened = 0; opened < k;)
+            {
+                const Gap gap = GapAt(c, UniformBelow(rng, total));
+                if (c.IsOpen(gap.rx, gap.ry, gap.dir)) continue;
+                c.Open(gap.rx, gap.ry, gap.dir);
+                ++opened;
+            }
+            return;
+        }
+
+        // 稠密：k 与墙缝总数同阶，顺序抽样扫描一遍：剩 left 条里还要 need 条，当前这条以 need/left 的概率入选
+        // （Knuth 算法 S，整数判定，不额外占内存）；打通一条不影响其他墙缝的开关
+        uint64_t left = closed, need = k;
+        for (uint64_t i = 0; i < total && need > 0; ++i)
+        {
+            const Gap gap = GapAt(c, i);
+            if (c.IsOpen(gap.rx, gap.ry, gap.dir)) continue;
+            if (need == left || UniformBelow(rng, left) < need)
+            {
+                c.Open(gap.rx, gap.ry, gap.dir);
+                --need;
+            }
+            --left;
+        }
+    }
+
+    template <class Carver>
+    int OpenSides(const Carver& c, int32_t rx, int32_t ry) {
+        int n = 0;
+        for (int dir = 0; dir < 4; ++dir)
+            n += HasNeighbour(c, rx, ry, dir) && c.IsOpen(rx, ry, dir);
+        return n;
+    }
+
+    // 行主序逐个死路（只有一面通的房间）以概率 p 再打通一面墙，优先打向另一个死路，一次消掉两个；
+    // 前面打通的会让后面的房间不再是死路。返回打通的墙数
+    // 整图扫描一遍，O(房间数)，与 braidRatio 无关：完美迷宫的死路本身就与房间数同阶，
+    // 生成时收集候选也省不掉这一量级，这里不做
+    template <class Carver>
+    uint64_t RemoveDeadEnds(Carver& c, double p, Rng& rng)
+    {
+        if (p <= 0.0) return 0;
+        const uint64_t threshold = (p >= 1.0) ? 0 : (uint64_t)(p * 0x1.0p64);
+
+        uint64_t opened = 0;
+        for (int32_t ry = 0; ry < c.roomsH; ++ry)
+            for (int32_t rx = 0; rx < c.roomsW; ++rx)
+            {
+                if (OpenSides(c, rx, ry) != 1) continue;
+                if (threshold != 0 && rng.Next64() >= threshold) continue;
+
+                std::array<int, 4> any{}, toDeadEnd{};
+                int nAny = 0, nDeadEnd = 0;
+                for (int dir = 0; dir < 4; ++dir)
+                {
+                    if (!HasNeighbour(c, rx, ry, dir) || c.IsOpen(rx, ry, dir)) continue;
+                    any[nAny++] = dir;
+                    if (OpenSides(c, rx + PassageGrid::DirX[dir], ry + PassageGrid::DirY[dir]) == 1)
+                        toDeadEnd[nDeadEnd++] = dir;
+                }
+                if (nAny == 0) continue;
+
+                const auto& pool = (nDeadEnd > 0) ? toDeadEnd : any;
+                const int n = (nDeadEnd > 0) ? nDeadEnd : nAny;
+                const int dir = pool[(n == 1) ? 0 : UniformBelow(rng, (uint64_t)n)];
+                c.Open(rx, ry, dir);
+                ++opened;
+            }
+        return opened;
+    }
+
+    // 生成完美迷宫之后的打环。完美迷宫恰有 房间数-1 条通的墙缝，关着的条数不用数
+    template <class Carver>
+    void Braid(Carver& c, const BuildOptions& options, Rng& rng)
+    {
+        const uint64_t rooms = (uint64_t)c.roomsW * (uint64_t)c.roomsH;
+        if (rooms < 2) return;
+
+        const double ratio = std::clamp(options.braidRatio, 0.0, 1.0);
+        uint64_t closed = GapCount(c) - (rooms - 1);
+        uint64_t k = (uint64_t)std::max(0, options.extraLoops);
+
+        if (options.braid == BraidMode::DeadEnds)
+            closed -= RemoveDeadEnds(c, ratio, rng);
+        else
+            k += (uint64_t)std::llround(ratio * (double)closed);
+
+        OpenClosedGaps(c, closed, k, rng);
+    }
+}
+
+const char* MazeBuilder::GeneratorName(MazeGenerator generator)
+{
+    switch (generator)
+    {
+    case MazeGenerator::Backtracker: return "backtracker";
+    case MazeGenerator::Kruskal:     return "kruskal";
+    case MazeGenerator::Prim:        return "prim";
+    case MazeGenerator::Wilson:      return "wilson";
+    case MazeGenerator::HuntAndKill: return "hunt-and-kill";
+    case MazeGenerator::BinaryTree:  return "binary-tree";
+    case MazeGenerator::Sidewinder:  return "sidewinder";
+    case MazeGenerator::Eller:       return "eller";
+    case MazeGenerator::BinaryTreeSimd: return "binary-tree-simd";
+    case MazeGenerator::SidewinderSimd: return "sidewinder-simd";
+    }
+    return "?";
+}
+
+int32_t MazeBuilder::NormalizeSide(int32_t side)
+{
+    return std::clamp(side, MinSide, MaxSide) | 1;
+}
+
+Maze MazeBuilder::Build(int seed, MazeLayout layout)
+{
+    BuildOptions options;
+    options.layout = layout;
+    return Build(seed, DefaultSize, DefaultSize, options);
+}
+
+Maze MazeBuilder::Build(int seed, int32_t width, int32_t height, const BuildOptions& options)
+{
+    Maze maze;
+    Build(seed, width, height, options, maze);
     return maze;
-}
\ No newline at end of file
+}
+
+void MazeBuilder::Build(int seed, int32_t width, int32_t height, const BuildOptions& options, Maze& maze)
+{
+    const int32_t W = NormalizeSide(width);
+    const int32_t H = NormalizeSide(height);
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    maze.seed = seed;
+    maze.generator = options.generator;
+    maze.start = {};
+    maze.end = {};
+    maze.Resize(W, H, true, options.layout);
+    auto& walls = maze.walls;
+
+    Rng rng = SeedRng(seed);
+
+    if (options.tileRooms > 0)
+    {
+        const TiledRooms plan = CarveTiles(seed, (W - 1) / 2, (H - 1) / 2, options, rng);
+        WriteTiles(plan, walls, options.threads);
+    }
+    else if (options.generator == MazeGenerator::BinaryTreeSimd || options.generator == MazeGenerator::SidewinderSimd)
+    {
+        WriteWordRows(walls, (options.generator == MazeGenerator::BinaryTreeSimd) ? WordRows::Kind::BinaryTree
+                                                                                   : WordRows::Kind::Sidewinder, rng);
+    }
+    else
+    {
+        WallCarver carver{ walls, (W - 1) / 2, (H - 1) / 2 };
+        Carve(carver, options.generator, rng);
+    }
+
+    // 打环：多条路线
+    WallCarver braid{ walls, (W - 1) / 2, (H - 1) / 2 };
+    Braid(braid, options, rng);
+
+    if (options.structure)
+        Analyze(walls, maze.structure);
+    else
+        maze.structure.Clear();
+
+    maze.buildTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0);
+}
+
+void MazeBuilder::Analyze(const WallBitmap& walls, MazeStructure& out)
+{
+    const int32_t roomsW = std::max(0, (walls.width - 1) / 2);
+    const int32_t roomsH = std::max(0, (walls.height - 1) / 2);
+    const size_t rooms = (size_t)roomsW * (size_t)roomsH;
+
+    out.Clear();
+    out.roomsW = roomsW;
+    out.roomsH = roomsH;
+    out.degree.assign(rooms, 0);
+
+    // 度数：房间行 64 格一段，段从奇数列起，房间落在段内的偶数位；四个方向的墙缝各读一段
+    for (int32_t ry = 0; ry < roomsH; ++ry)
+    {
+        const int32_t y = ry * 2 + 1;
+        for (int32_t x0 = 1; x0 < roomsW * 2; x0 += (int32_t)WallBitmap::WordBits)
+        {
+            const uint64_t e = ~walls.Segment(x0 + 1, y);
+            const uint64_t w = ~walls.Segment(x0 - 1, y);
+            const uint64_t s = ~walls.Segment(x0, y + 1);
+            const uint64_t n = ~walls.Segment(x0, y - 1);
+
+            const int32_t rx0 = x0 / 2;
+            const int32_t count = std::min<int32_t>((int32_t)WallBitmap::WordBits / 2, roomsW - rx0);
+            for (int32_t k = 0; k < count; ++k)
+            {
+                const int bit = k * 2;
+                const uint8_t d = (uint8_t)(((e >> bit) & 1) + ((w >> bit) & 1) + ((s >> bit) & 1) + ((n >> bit) & 1));
+                out.degree[(size_t)ry * (size_t)roomsW + (size_t)(rx0 + k)] = d;
+
+                if (d == 1)      out.deadEnds.push_back({ (rx0 + k) * 2 + 1, y });
+                else if (d >= 3) out.junctions.push_back({ (rx0 + k) * 2 + 1, y });
+            }
+        }
+    }
+
+    // 走廊：从每个非度数 2 的房间沿每个通的方向走，穿过度数 2 的房间直到下一个非度数 2 的房间。
+    // 中间房间只属于一条走廊，走过就标记，另一端不再重走；两端直接相邻的由下标小的一端记录
+    auto passable = [&](int32_t rx, int32_t ry, int dir) {
+        const int32_t nx = rx + PassageGrid::DirX[dir];
+        const int32_t ny = ry + PassageGrid::DirY[dir];
+        return nx >= 0 && ny >= 0 && nx < roomsW && ny < roomsH
+            && !walls.Test(rx * 2 + 1 + PassageGrid::DirX[dir], ry * 2 + 1 + PassageGrid::DirY[dir]);
+    };
+
+    std::vector<uint8_t> walked(rooms, 0);
+    for (int32_t ay = 0; ay < roomsH; ++ay)
+        for (int32_t ax = 0; ax < roomsW; ++ax)
+        {
+            const size_t a = (size_t)ay * (size_t)roomsW + (size_t)ax;
+            if (out.degree[a] == 2 || out.degree[a] == 0) continue;
+
+            for (int first = 0; first < 4; ++first)
+            {
+                if (!passable(ax, ay, first)) continue;
+
+                int32_t rx = ax + PassageGrid::DirX[first];
+                int32_t ry = ay + PassageGrid::DirY[first];
+                size_t r = (size_t)ry * (size_t)roomsW + (size_t)rx;
+                if (out.degree[r] == 2 ? walked[r] != 0 : r < a) continue;
+
+                int from = first;
+                int32_t length = 2;
+                while (out.degree[r] == 2)
+                {
+                    walked[r] = 1;
+                    int next = -1;
+                    for (int dir = 0; dir < 4 && next < 0; ++dir)
+                        if (dir != (from ^ 1) && passable(rx, ry, dir)) next = dir;
+                    if (next < 0) break;   // 另一侧通向外圈（如起终点打通了边界）
+
+                    rx += PassageGrid::DirX[next];
+                    ry += PassageGrid::DirY[next];
+                    r = (size_t)ry * (size_t)roomsW + (size_t)rx;
+                    from = next;
+                    length += 2;
+                }
+
+                out.corridors.push_back({ { ax * 2 + 1, ay * 2 + 1 }, { rx * 2 + 1, ry * 2 + 1 }, length });
+            }
+        }
+}
+
+void MazeBuilder::BuildBatch(std::span<const int> seeds, int32_t width, int32_t height, const BuildOptions& options,
+                             int32_t threads, const MazeBatchSink& sink)
+{
+    // 每个工作线程一个 Maze：尺寸不变时位图的 vector 只在第一次分配
+    std::vector<Maze> scratch(WorkerCount(seeds.size(), threads));
+    ParallelFor(seeds.size(), threads, [&](size_t i, size_t worker) {
+        Maze& maze = scratch[worker];
+        Build(seeds[i], width, height, options, maze);
+        sink(i, maze);
+    });
+}
+
+std::vector<Maze> MazeBuilder::BuildBatch(std::span<const int> seeds, int32_t width, int32_t height,
+                                          const BuildOptions& options, int32_t threads)
+{
+    std::vector<Maze> out(seeds.size());
+    ParallelFor(seeds.size(), threads, [&](size_t i, size_t) {
+        Build(seeds[i], width, height, options, out[i]);
+    });
+    return out;
+}
+
+PassageGrid MazeBuilder::BuildPassages(int seed)
+{
+    return BuildPassages(seed, DefaultSize, DefaultSize);
+}
+
+PassageGrid MazeBuilder::BuildPassages(int seed, int32_t width, int32_t height, const BuildOptions& options)
+{
+    const int32_t W = NormalizeSide(width);
+    const int32_t H = NormalizeSide(height);
+    const int32_t ROOMS_W = (W - 1) / 2;
+    const int32_t ROOMS_H = (H - 1) / 2;
+
+    PassageGrid g;
+    g.seed = seed;
+    g.generator = options.generator;
+    g.Resize(ROOMS_W, ROOMS_H);
+
+    // same RNG stream and carving order as Build(), written as per-room masks
+    Rng rng = SeedRng(seed);
+
+    if (options.tileRooms > 0)
+    {
+        const TiledRooms plan = CarveTiles(seed, ROOMS_W, ROOMS_H, options, rng);
+        for (int32_t ry = 0; ry < ROOMS_H; ++ry)
+            for (int32_t rx = 0; rx < ROOMS_W; ++rx)
+            {
+                const uint8_t m = plan.Mask(rx, ry);
+                if (m & PassageGrid::East)  g.Open(rx, ry, 0);
+                if (m & PassageGrid::South) g.Open(rx, ry, 2);
+            }
+        for (const Gap& seam : plan.seams)
+            g.Open(seam.rx, seam.ry, seam.dir);
+    }
+    else
+    {
+        PassageCarver carver{ g, ROOMS_W, ROOMS_H };
+        Carve(carver, options.generator, rng);
+    }
+
+    // same braid pass as Build(), on the masks
+    PassageCarver braid{ g, ROOMS_W, ROOMS_H };
+    Braid(braid, options, rng);
+
+    return g;
+}
+
+void MazeBuilder::BuildChunk(int seed, int32_t cx, int32_t cy, int32_t chunkRooms, MazeGenerator generator,
+                             WallBitmap& walls)
+{
+    // 多留一行一列墙（属于东、南邻块的接缝），生成器可以照常用房间东南角的柱子
+    const int32_t side = chunkRooms * 2;
+    walls.Resize(side + 1, side + 1, true);
+
+    // 块号打包成 Philox 的块计数器：块内随机流与接缝位置都只取决于 (seed, cx, cy)
+    const uint64_t key = ((uint64_t)(uint32_t)cx << 32) | (uint64_t)(uint32_t)cy;
+
+    Rng rng(Philox::At64((uint64_t)(uint32_t)seed, key, 0));
+    WallCarver carver{ walls, chunkRooms, chunkRooms };
+    Carve(carver, generator, rng);
+
+    // 本块拥有西、北两条接缝（第 0 列、第 0 行），各开一个口；东、南接缝属于邻块
+    Rng seams(Philox::At64((uint64_t)(uint32_t)seed, key, 1));
+    const int32_t west  = (int32_t)UniformBelow(seams, (uint64_t)chunkRooms);
+    const int32_t north = (int32_t)UniformBelow(seams, (uint64_t)chunkRooms);
+    walls.Clear(0, west * 2 + 1);
+    walls.Clear(north * 2 + 1, 0);
+}
+
+void MazeBuilder::BuildStream(int seed, int32_t width, int32_t height, const MazeRowSink& sink)
+{
+    const int32_t W = NormalizeSide(width);
+    const int32_t H = std::max(height, MinSide) | 1;
+    const int32_t ROOMS_W = (W - 1) / 2;
+    const int32_t ROOMS_H = (H - 1) / 2;
+
+    // same RNG stream as Build() with generator=Eller: Carve() draws nothing before the rows
+    Rng rng = SeedRng(seed);
+
+    const size_t words = ((size_t)W + WallBitmap::WordBits - 1) / WallBitmap::WordBits;
+    std::vector<uint64_t> roomRow(words), gapRow(words);
+
+    // top border
+    std::fill(gapRow.begin(), gapRow.end(), ~0ull);
+    sink(0, gapRow);
+
+    // 每个房间行整字展开成两条网格行：房间行（含向东的墙缝）和下方的墙行（向南的墙缝；最后一行即下边界）
+    EllerRows rows(ROOMS_W);
+    for (int32_t ry = 0; ry < ROOMS_H; ++ry)
+    {
+        rows.Next(rng, ry + 1 == ROOMS_H);
+        WordRows::ExpandRow(rows.Valid(), rows.West(), rows.South(), gapRow, roomRow);
+        sink(ry * 2 + 1, roomRow);
+        sink(ry * 2 + 2, gapRow);
+    }
+}
@@ -0,0 +1,400 @@
+#include "core/MazeFile.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr uint64_t PAGE_ALIGN = 4096;
+
+static uint64_t AlignUp(uint64_t v, uint64_t a)
+{
+    return (v + a - 1) / a * a;
+}
+
+// 行主序 = width * 64 位一条带；分块 = 每行块数 * 8 个块行
+static uint64_t WordsPerBand(MazeLayout layout, int32_t width, int32_t tilesPerRow)
+{
+    return (layout == MazeLayout::Tiled8x8)
+        ? (uint64_t)tilesPerRow * (MazeFile::BandRows / WallBitmap::TileSide)
+        : (uint64_t)width * MazeFile::BandRows / WallBitmap::WordBits;
+}
+
+static MazeFileBand BandAt(uint64_t wordsPerBand, uint64_t total, uint64_t band)
+{
+    const uint64_t first = band * wordsPerBand;
+    if (first >= total) return { total, 0 };
+    return { first, std::min(wordsPerBand, total - first) };
+}
+
+// 写出文件头、条带目录和对齐填充，之后紧接位图字数组
+static void WriteHeader(std::ofstream& out, MazeFileHeader& h, uint64_t wordsPerBand)
+{
+    h.bandRows  = MazeFile::BandRows;
+    h.bandCount = ((uint64_t)h.height + MazeFile::BandRows - 1) / MazeFile::BandRows;
+    h.directoryOffset = sizeof(MazeFileHeader);
+    h.dataOffset = AlignUp(h.directoryOffset + h.bandCount * sizeof(MazeFileBand), PAGE_ALIGN);
+
+    std::vector<MazeFileBand> dir(h.bandCount);
+    for (uint64_t i = 0; i < h.bandCount; ++i)
+        dir[i] = BandAt(wordsPerBand, h.wordCount, i);
+
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(dir.data()), (std::streamsize)(dir.size() * sizeof(MazeFileBand)));
+
+    const uint64_t pad = h.dataOffset - (h.directoryOffset + dir.size() * sizeof(MazeFileBand));
+    const std::vector<char> zeros(pad, 0);
+    out.write(zeros.data(), (std::streamsize)zeros.size());
+}
+
+MazeFileBand MazeFile::BandRange(const WallBitmap& walls, uint64_t band)
+{
+    return BandAt(WordsPerBand(walls.layout, walls.width, walls.tilesPerRow), walls.WordCount(), band);
+}
+
+void MazeFile::Save(const Maze& maze, const std::string& path)
+{
+    const WallBitmap& walls = maze.walls;
+
+    MazeFileHeader h{};
+    std::memcpy(h.magic, "MAZE", 4);
+    h.version   = Version;
+    h.width     = maze.width;
+    h.height    = maze.height;
+    h.seed      = maze.seed;
+    h.generator = (uint32_t)maze.generator;
+    h.layout    = (uint32_t)walls.layout;
+    h.startX    = maze.start.x;
+    h.startY    = maze.start.y;
+    h.endX      = maze.end.x;
+    h.endY      = maze.end.y;
+    h.wordCount = walls.WordCount();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("MazeFile::Save: cannot open " + path);
+
+    WriteHeader(out, h, WordsPerBand(walls.layout, walls.width, walls.tilesPerRow));
+
+    out.write(reinterpret_cast<const char*>(walls.Data()), (std::streamsize)(h.wordCount * sizeof(uint64_t)));
+    if (!out)
+        throw std::runtime_error("MazeFile::Save: write failed for " + path);
+}
+
+std::pair<MazeFileHeader, std::vector<MazeFileBand>> MazeFile::ReadDirectory(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("MazeFile: cannot open " + path);
+
+    MazeFileHeader h{};
+    in.read(reinterpret_cast<char*>(&h), sizeof(h));
+    if (!in || std::memcmp(h.magic, "MAZE", 4) != 0)
+        throw std::runtime_error("MazeFile: not a maze file: " + path);
+    if (h.version != Version)
+        throw std::runtime_error("MazeFile: unsupported version in " + path);
+    if (h.width <= 0 || h.height <= 0 || h.layout > (uint32_t)MazeLayout::Tiled8x8
+        || h.generator > (uint32_t)MazeGenerator::SidewinderSimd)
+        throw std::runtime_error("MazeFile: corrupt header in " + path);
+
+    std::vector<MazeFileBand> dir(h.bandCount);
+    in.seekg((std::streamoff)h.directoryOffset);
+    in.read(reinterpret_cast<char*>(dir.data()), (std::streamsize)(dir.size() * sizeof(MazeFileBand)));
+    if (!in)
+        throw std::runtime_error("MazeFile: truncated directory in " + path);
+
+    return { h, std::move(dir) };
+}
+
+Maze MazeFile::Open(const std::string& path)
+{
+    const MazeFileHeader h = ReadDirectory(path).first;
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("MazeFile::Open: cannot open " + path);
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || (uint64_t)st.st_size < h.dataOffset + h.wordCount * sizeof(uint64_t))
+    {
+        ::close(fd);
+        throw std::runtime_error("MazeFile::Open: truncated file " + path);
+    }
+
+    const size_t mapLen = (size_t)st.st_size;
+    // 私有可写映射：Viewer 打通起终点时只写到本进程的副本页
+    void* base = ::mmap(nullptr, mapLen, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED)
+        throw std::runtime_error("MazeFile::Open: mmap failed for " + path);
+
+    ::madvise(base, mapLen, MADV_RANDOM);
+
+    Maze maze;
+    maze.seed   = h.seed;
+    maze.generator = (MazeGenerator)h.generator;
+    maze.width  = h.width;
+    maze.height = h.height;
+    maze.start  = { h.startX, h.startY };
+    maze.end    = { h.endX, h.endY };
+
+    WallBitmap& walls = maze.walls;
+    walls.width  = h.width;
+    walls.height = h.height;
+    walls.layout = (MazeLayout)h.layout;
+    walls.tilesPerRow = (walls.layout == MazeLayout::Tiled8x8)
+        ? (h.width + WallBitmap::TileSide - 1) / WallBitmap::TileSide
+        : 0;
+
+    const uint64_t expected = (walls.layout == MazeLayout::Tiled8x8)
+        ? (uint64_t)walls.tilesPerRow * (((uint64_t)h.height + WallBitmap::TileSide - 1) / WallBitmap::TileSide)
+        : ((uint64_t)h.width * (uint64_t)h.height + WallBitmap::WordBits - 1) / WallBitmap::WordBits;
+    if (h.wordCount != expected)
+    {
+        ::munmap(base, mapLen);
+        throw std::runtime_error("MazeFile::Open: bitmap size mismatch in " + path);
+    }
+
+    auto* data = reinterpret_cast<uint64_t*>(static_cast<char*>(base) + h.dataOffset);
+    walls.mapped = std::shared_ptr<uint64_t>(data, [base, mapLen](uint64_t*) { ::munmap(base, mapLen); });
+    walls.mappedWords = h.wordCount;
+
+    return maze;
+}
+
+void MazeFile::Prefetch(const Maze& maze, int32_t y0, int32_t y1)
+{
+    const WallBitmap& walls = maze.walls;
+    if (!walls.mapped || y1 <= y0) return;
+
+    y0 = std::clamp(y0, 0, walls.height);
+    y1 = std::clamp(y1, 0, walls.height);
+    const MazeFileBand a = BandRange(walls, (uint64_t)y0 / BandRows);
+    const MazeFileBand b = BandRange(walls, (uint64_t)(y1 - 1) / BandRows);
+
+    const uintptr_t page  = (uintptr_t)::sysconf(_SC_PAGESIZE);
+    const uintptr_t begin = (uintptr_t)(walls.Data() + a.firstWord) & ~(page - 1);
+    const uintptr_t end   = (uintptr_t)(walls.Data() + b.firstWord + b.wordCount);
+    ::madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+}
+
+MazeFileWriter::MazeFileWriter(const std::string& path, int32_t width, int32_t height, int32_t seed,
+                               MazeGenerator generator, Point start, Point end)
+    : out(path, std::ios::binary | std::ios::trunc), path(path), width(width), height(height)
+{
+    if (!out)
+        throw std::runtime_error("MazeFileWriter: cannot open " + path);
+
+    MazeFileHeader h{};
+    std::memcpy(h.magic, "MAZE", 4);
+    h.version   = MazeFile::Version;
+    h.width     = width;
+    h.height    = height;
+    h.seed      = seed;
+    h.generator = (uint32_t)generator;
+    h.layout    = (uint32_t)MazeLayout::RowMajor;
+    h.startX    = start.x;
+    h.startY    = start.y;
+    h.endX      = end.x;
+    h.endY      = end.y;
+    h.wordCount = ((uint64_t)width * (uint64_t)height + WallBitmap::WordBits - 1) / WallBitmap::WordBits;
+
+    WriteHeader(out, h, WordsPerBand(MazeLayout::RowMajor, width, 0));
+}
+
+void MazeFileWriter::Put(uint64_t word)
+{
+    out.write(reinterpret_cast<const char*>(&word), sizeof(word));
+}
+
+void MazeFileWriter::WriteRow(std::span<const uint64_t> row)
+{
+    if (rows >= height)
+        throw std::runtime_error("MazeFileWriter: too many rows for " + path);
+
+    // 行在文件里紧接上一行的最后一位：逐字移位拼接
+    int32_t remain = width;
+    for (size_t i = 0; remain > 0; ++i)
+    {
+        const uint32_t n = (uint32_t)std::min<int32_t>(remain, (int32_t)WallBitmap::WordBits);
+        const uint64_t v = (n == WallBitmap::WordBits) ? row[i] : (row[i] & ((1ull << n) - 1));
+
+        acc |= v << accBits;
+        if (accBits + n >= WallBitmap::WordBits)
+        {
+            Put(acc);
+            const uint32_t used = (uint32_t)WallBitmap::WordBits - accBits;
+            acc = (used < WallBitmap::WordBits) ? (v >> used) : 0;
+            accBits = accBits + n - (uint32_t)WallBitmap::WordBits;
+        }
+        else
+        {
+            accBits += n;
+        }
+        remain -= (int32_t)n;
+    }
+    ++rows;
+}
+
+void MazeFileWriter::Finish()
+{
+    if (rows != height)
+        throw std::runtime_error("MazeFileWriter: expected " + std::to_string(height) + " rows, got "
+                                 + std::to_string(rows) + " for " + path);
+
+    // 末字超出位图的位按约定为 1
+    if (accBits > 0)
+    {
+        Put(acc | (~0ull << accBits));
+        acc = 0;
+        accBits = 0;
+    }
+
+    out.flush();
+    if (!out)
+        throw std::runtime_error("MazeFileWriter: write failed for " + path);
+}
+
+MazeCorpus MazeCorpus::Open(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("MazeCorpus::Open: cannot open " + path);
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(MazeCorpusHeader))
+    {
+        ::close(fd);
+        throw std::runtime_error("MazeCorpus::Open: truncated file " + path);
+    }
+
+    const size_t mapLen = (size_t)st.st_size;
+    void* base = ::mmap(nullptr, mapLen, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED)
+        throw std::runtime_error("MazeCorpus::Open: mmap failed for " + path);
+
+    MazeCorpus corpus;
+    corpus.base = std::shared_ptr<char>(static_cast<char*>(base), [mapLen](char* p) { ::munmap(p, mapLen); });
+    std::memcpy(&corpus.header, base, sizeof(MazeCorpusHeader));
+
+    const MazeCorpusHeader& h = corpus.header;
+    if (std::memcmp(h.magic, "MZCP", 4) != 0)
+        throw std::runtime_error("MazeCorpus::Open: not a corpus file: " + path);
+    if (h.version != Version)
+        throw std::runtime_error("MazeCorpus::Open: unsupported version in " + path);
+    if (h.width <= 0 || h.height <= 0 || h.layout > (uint32_t)MazeLayout::Tiled8x8
+        || h.generator > (uint32_t)MazeGenerator::SidewinderSimd
+        || h.indexOffset % alignof(MazeCorpusEntry) != 0
+        || h.indexOffset + h.count * sizeof(MazeCorpusEntry) > mapLen)
+        throw std::runtime_error("MazeCorpus::Open: corrupt header in " + path);
+
+    corpus.index = reinterpret_cast<const MazeCorpusEntry*>(corpus.base.get() + h.indexOffset);
+    for (size_t i = 0; i < corpus.Count(); ++i)
+        if (corpus.index[i].offset + h.wordsPerMaze * sizeof(uint64_t) > h.indexOffset)
+            throw std::runtime_error("MazeCorpus::Open: corrupt index in " + path);
+
+    return corpus;
+}
+
+Maze MazeCorpus::At(size_t i) const
+{
+    Maze maze;
+    maze.seed      = index[i].seed;
+    maze.generator = (MazeGenerator)header.generator;
+    maze.width     = header.width;
+    maze.height    = header.height;
+    maze.start     = { header.startX, header.startY };
+    maze.end       = { header.endX, header.endY };
+
+    WallBitmap& walls = maze.walls;
+    walls.width  = header.width;
+    walls.height = header.height;
+    walls.layout = (MazeLayout)header.layout;
+    walls.tilesPerRow = (walls.layout == MazeLayout::Tiled8x8)
+        ? (header.width + WallBitmap::TileSide - 1) / WallBitmap::TileSide
+        : 0;
+
+    // 与映射共享所有权，语料对象先析构也不影响取出的迷宫
+    walls.mapped = std::shared_ptr<uint64_t>(base, reinterpret_cast<uint64_t*>(base.get() + index[i].offset));
+    walls.mappedWords = header.wordsPerMaze;
+    return maze;
+}
+
+Maze MazeCorpus::Find(int32_t seed) const
+{
+    const MazeCorpusEntry* end = index + Count();
+    const MazeCorpusEntry* it = std::lower_bound(index, end, seed,
+        [](const MazeCorpusEntry& e, int32_t s) { return e.seed < s; });
+    if (it == end || it->seed != seed) return {};
+    return At((size_t)(it - index));
+}
+
+MazeCorpusWriter::MazeCorpusWriter(const std::string& path, int32_t width, int32_t height, MazeGenerator generator,
+                                   MazeLayout layout, Point start, Point end)
+    : out(path, std::ios::binary | std::ios::trunc), path(path)
+{
+    if (!out)
+        throw std::runtime_error("MazeCorpusWriter: cannot open " + path);
+
+    // 只用来算每个迷宫的字数
+    WallBitmap shape;
+    shape.Resize(width, height, true, layout);
+
+    std::memcpy(header.magic, "MZCP", 4);
+    header.version   = MazeCorpus::Version;
+    header.width     = width;
+    header.height    = height;
+    header.generator = (uint32_t)generator;
+    header.layout    = (uint32_t)layout;
+    header.startX    = start.x;
+    header.startY    = start.y;
+    header.endX      = end.x;
+    header.endY      = end.y;
+    header.wordsPerMaze = shape.WordCount();
+
+    // 先占位，Finish 时回填 count / indexOffset
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    offset = sizeof(header);
+}
+
+void MazeCorpusWriter::Add(const Maze& maze)
+{
+    const WallBitmap& walls = maze.walls;
+    if (maze.width != header.width || maze.height != header.height
+        || walls.layout != (MazeLayout)header.layout || walls.WordCount() != header.wordsPerMaze)
+        throw std::runtime_error("MazeCorpusWriter: maze shape differs from corpus " + path);
+
+    std::lock_guard<std::mutex> guard(lock);
+    out.write(reinterpret_cast<const char*>(walls.Data()), (std::streamsize)(header.wordsPerMaze * sizeof(uint64_t)));
+    index.push_back({ maze.seed, 0, offset });
+    offset += header.wordsPerMaze * sizeof(uint64_t);
+}
+
+void MazeCorpusWriter::Finish()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    std::stable_sort(index.begin(), index.end(),
+        [](const MazeCorpusEntry& a, const MazeCorpusEntry& b) { return a.seed < b.seed; });
+
+    header.count = index.size();
+    header.indexOffset = offset;
+    out.write(reinterpret_cast<const char*>(index.data()), (std::streamsize)(index.size() * sizeof(MazeCorpusEntry)));
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.flush();
+    if (!out)
+        throw std::runtime_error("MazeCorpusWriter: write failed for " + path);
+}
+
+uint64_t MazeCorpusWriter::Count() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return index.size();
+}
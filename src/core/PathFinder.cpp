@@ -1,4 +1,5 @@
 #include "core/PathFinder.hpp"
+#include "core/JunctionGraph.hpp"
 
 static int Heuristic(const Point& a, const Point& b)
 {
@@ -6,171 +7,709 @@ static int Heuristic(const Point& a, const Point& b)
     return std::abs(a.x - b.x) + std::abs(a.y - b.y);
 }
  //最短路径 使用A* 和 曼哈顿启发算法
-std::tuple<std::vector<Point>, std::vector<Point>, int32_t, std::chrono::milliseconds>
-PathFinder::pathFinder(Maze maze)
+SearchResult PathFinder::pathFinder(MazeView maze)
 {
-    auto startTime = std::chrono::high_resolution_clock::now();
+    SearchResult out;
+    pathFinder(maze, out);
+    return out;
+}
 
-    struct Node {
-        Point p;
-        int g;
-        int f;
-    };
+void PathFinder::pathFinder(MazeView maze, SearchResult& out)
+{
+    SearchContext ctx;
+    pathFinder(maze, ctx, out);
+}
+
+void PathFinder::pathFinder(MazeView maze, SearchContext& ctx, SearchResult& out)
+{
+    ctx.Bind(maze);
+    pathFinder(ctx, maze.start, maze.end, out);
+}
 
-    auto cmp = [](const Node& a, const Node& b) {
-        return a.f > b.f;
+namespace
+{
+    using OpenNode = SearchContext::OpenNode;
+
+    // 二叉堆：与 std::priority_queue 用同一组堆算法，出堆顺序和原来一致
+    struct HeapOpenList
+    {
+        std::vector<OpenNode>& heap;
+
+        static bool Less(const OpenNode& a, const OpenNode& b) { return a.f > b.f; }
+
+        bool Empty() const { return heap.empty(); }
+        int32_t MinF() const { return heap.front().f; }
+        void Push(const OpenNode& n) {
+            heap.push_back(n);
+            std::push_heap(heap.begin(), heap.end(), Less);
+        }
+        OpenNode Pop() {
+            std::pop_heap(heap.begin(), heap.end(), Less);
+            const OpenNode n = heap.back();
+            heap.pop_back();
+            return n;
+        }
     };
 
-    std::priority_queue<Node, std::vector<Node>, decltype(cmp)> openSet(cmp);
-    std::unordered_map<int, Point> cameFrom;
-    std::unordered_map<int, int> costSoFar;
+    // 按 f 分桶
+    struct BucketOpenList
+    {
+        BucketQueue<OpenNode>& queue;
 
-    auto key = [&](int x, int y) {
-        return y * maze.width + x;
+        bool Empty() const { return queue.Empty(); }
+        int32_t MinF() { return (int32_t)queue.MinKey(); }
+        void Push(const OpenNode& n) { queue.Push((uint32_t)n.f, n); }
+        OpenNode Pop() { return queue.Pop(); }
     };
 
-    openSet.push({ maze.start, 0, Heuristic(maze.start, maze.end) });
-    costSoFar[key(maze.start.x, maze.start.y)] = 0;
+    template<class OpenList>
+    void AStar(SearchContext& ctx, OpenList openSet, Point start, Point end, SearchResult& out)
+    {
+        auto& visitedPoints = out.visited;
+        auto& path = out.path;
 
-    std::vector<Point> visitedPoints;
-    std::vector<Point> path;
+        // 带哨兵外圈的网格：邻居只需一次查表，不做越界检查
+        const PaddedGrid& grid = ctx.grid;
+        const auto& off = grid.offsets;
+        const uint32_t epoch = ctx.epoch;
 
-    const int dx[4] = { 1, -1, 0, 0 };
-    const int dy[4] = { 0, 0, 1, -1 };
+        const size_t startIdx = grid.Index(start.x, start.y);
+        const size_t endIdx = grid.Index(end.x, end.y);
+        openSet.Push({ start, startIdx, 0, Heuristic(start, end) });
+        ctx.g[startIdx] = 0;
+        ctx.stamp[startIdx] = epoch;
+
+        const int dx[4] = { 1, -1, 0, 0 };
+        const int dy[4] = { 0, 0, 1, -1 };
+
+        while (!openSet.Empty())
+        {
+            const OpenNode current = openSet.Pop();
+
+            // ⭐ 记录访问节点
+            visitedPoints.push_back(current.p);
+            ++out.expanded;
+
+            if (current.idx == endIdx)
+            {
+                // 沿 2 位来向倒推，不需要存父节点坐标
+                Point cur = end;
+                size_t k = endIdx;
+                while (k != startIdx)
+                {
+                    path.push_back(cur);
+                    const uint8_t d = ctx.Parent(k);
+                    k -= off[d];
+                    cur = { cur.x - dx[d], cur.y - dy[d] };
+                }
+                path.push_back(start);
+                std::reverse(path.begin(), path.end());
+                break;
+            }
+
+            for (int i = 0; i < 4; ++i)
+            {
+                const size_t k = current.idx + off[i];
+                if (grid.cells[k] != PaddedGrid::Open) continue;
 
-    while (!openSet.empty())
+                const int newCost = current.g + 1;
+                if (ctx.Seen(k) && newCost >= ctx.g[k]) continue;
+
+                ctx.stamp[k] = epoch;
+                ctx.g[k] = newCost;
+                ctx.SetParent(k, (uint8_t)i);
+
+                const Point np{ current.p.x + dx[i], current.p.y + dy[i] };
+                openSet.Push({ np, k, newCost, newCost + Heuristic(np, end) });
+            }
+        }
+    }
+
+    constexpr size_t NoJump = (size_t)-1;
+
+    // 从 idx 沿方向 d 直走（调用方保证第一步可走），停在：起点 / 终点、两侧有开口的格子（岔路或拐角）；
+    // 前方堵住且两侧无口是死胡同，返回 NoJump。dist 为走过的步数
+    size_t Jump(const PaddedGrid& grid, size_t idx, int d, size_t startIdx, size_t endIdx, int32_t& dist)
+    {
+        const auto& off = grid.offsets;
+        const ptrdiff_t step = off[d];
+        const int side = (d < 2) ? 2 : 0;            // 横走看上下，竖走看左右
+        const ptrdiff_t sideA = off[side];
+        const ptrdiff_t sideB = off[side + 1];
+
+        dist = 0;
+        for (;;)
+        {
+            idx += step;
+            ++dist;
+            if (idx == endIdx || idx == startIdx) return idx;
+            if (grid.cells[idx + sideA] == PaddedGrid::Open || grid.cells[idx + sideB] == PaddedGrid::Open) return idx;
+            if (grid.cells[idx + step] != PaddedGrid::Open) return NoJump;
+        }
+    }
+
+    // 跳点搜索：开放表里只有跳点，g 按跳过的步数累加；跳点之间都是直走廊，
+    // 走廊中间的格子永远不会被打上本轮纪元，倒推时沿来向退到第一个打过纪元的格子就是上一个跳点
+    template<class OpenList>
+    void JumpPoint(SearchContext& ctx, OpenList openSet, Point start, Point end, SearchResult& out)
     {
-        Node current = openSet.top();
-        openSet.pop();
+        auto& path = out.path;
 
-        // ⭐ 记录访问节点
-        visitedPoints.push_back(current.p);
+        const PaddedGrid& grid = ctx.grid;
+        const auto& off = grid.offsets;
+        const uint32_t epoch = ctx.epoch;
 
-        if (current.p == maze.end)
+        const size_t startIdx = grid.Index(start.x, start.y);
+        const size_t endIdx = grid.Index(end.x, end.y);
+        openSet.Push({ start, startIdx, 0, Heuristic(start, end) });
+        ctx.g[startIdx] = 0;
+        ctx.stamp[startIdx] = epoch;
+
+        const int dx[4] = { 1, -1, 0, 0 };
+        const int dy[4] = { 0, 0, 1, -1 };
+
+        while (!openSet.Empty())
         {
-            Point cur = maze.end;
-            while (!(cur == maze.start))
+            const OpenNode current = openSet.Pop();
+            if (current.g != ctx.g[current.idx]) continue;   // 已有更短的记录，过期条目
+
+            out.visited.push_back(current.p);
+            ++out.expanded;
+
+            if (current.idx == endIdx)
             {
-                path.push_back(cur);
-                cur = cameFrom[key(cur.x, cur.y)];
+                Point cur = end;
+                size_t k = endIdx;
+                while (k != startIdx)
+                {
+                    const uint8_t d = ctx.Parent(k);
+                    do
+                    {
+                        path.push_back(cur);
+                        k -= off[d];
+                        cur = { cur.x - dx[d], cur.y - dy[d] };
+                    } while (!ctx.Seen(k));
+                }
+                path.push_back(start);
+                std::reverse(path.begin(), path.end());
+                break;
+            }
+
+            // 不往回跳：回头只会以更大的代价回到父跳点
+            const int back = (current.idx == startIdx) ? -1 : (ctx.Parent(current.idx) ^ 1);
+            for (int i = 0; i < 4; ++i)
+            {
+                if (i == back || grid.cells[current.idx + off[i]] != PaddedGrid::Open) continue;
+
+                int32_t dist = 0;
+                const size_t k = Jump(grid, current.idx, i, startIdx, endIdx, dist);
+                if (k == NoJump) continue;
+
+                const int newCost = current.g + dist;
+                if (ctx.Seen(k) && newCost >= ctx.g[k]) continue;
+
+                ctx.stamp[k] = epoch;
+                ctx.g[k] = newCost;
+                ctx.SetParent(k, (uint8_t)i);
+
+                const Point np{ current.p.x + dx[i] * dist, current.p.y + dy[i] * dist };
+                openSet.Push({ np, k, newCost, newCost + Heuristic(np, end) });
             }
-            path.push_back(maze.start);
-            std::reverse(path.begin(), path.end());
-            break;
         }
+    }
 
-        for (int i = 0; i < 4; ++i)
+    // 双向 A*，两侧用平均势：pF(n) = (h(n, end) - h(n, start)) / 2，pB = -pF。两者都一致，且 pF + pB = 0，
+    // 相当于在约化边权上做双向 Dijkstra。键取两倍再加偏移 D = h(start, end) 保证是非负整数：
+    //   正向 2g + h(n, end) - h(n, start) + D，反向 2g + h(n, start) - h(n, end) + D
+    // 一侧给某格定下更小的 g、另一侧也到过它时得到一条完整路径，记下最短的 best；
+    // 两侧开放表最小键之和 >= 2 * best + 2D 时停止（经过任何未展开节点的路径都不会更短）。两侧轮流各弹一个节点
+    template<class OpenList>
+    void Bidirectional(SearchContext& ctx, OpenList forwardSet, OpenList backwardSet, Point start, Point end, SearchResult& out)
+    {
+        auto& path = out.path;
+
+        const PaddedGrid& grid = ctx.grid;
+        const auto& off = grid.offsets;
+        const uint32_t epoch = ctx.epoch;
+
+        const size_t startIdx = grid.Index(start.x, start.y);
+        const size_t endIdx = grid.Index(end.x, end.y);
+        if (startIdx == endIdx)
+        {
+            out.visited.push_back(start);
+            out.expanded = 1;
+            path.push_back(start);
+            return;
+        }
+        // 与单向一致：终点必须能走进去（起点在墙上仍可以走出来）
+        if (grid.cells[endIdx] != PaddedGrid::Open)
+            return;
+
+        const int32_t D = Heuristic(start, end);
+        auto key = [&](Point p, int32_t g, bool forward) {
+            const int32_t toEnd = Heuristic(p, end);
+            const int32_t toStart = Heuristic(p, start);
+            return 2 * g + (forward ? toEnd - toStart : toStart - toEnd) + D;
+        };
+
+        forwardSet.Push({ start, startIdx, 0, key(start, 0, true) });
+        ctx.g[startIdx] = 0;
+        ctx.stamp[startIdx] = epoch;
+        backwardSet.Push({ end, endIdx, 0, key(end, 0, false) });
+        ctx.gBack[endIdx] = 0;
+        ctx.stampBack[endIdx] = epoch;
+
+        const int dx[4] = { 1, -1, 0, 0 };
+        const int dy[4] = { 0, 0, 1, -1 };
+
+        int32_t best = INT32_MAX;
+        size_t meet = (size_t)-1;
+
+        auto expand = [&](OpenList& openSet, bool forward)
         {
-            int nx = current.p.x + dx[i];
-            int ny = current.p.y + dy[i];
+            auto& g = forward ? ctx.g : ctx.gBack;
+            auto& stamp = forward ? ctx.stamp : ctx.stampBack;
+            const auto& otherG = forward ? ctx.gBack : ctx.g;
+            const auto& otherStamp = forward ? ctx.stampBack : ctx.stamp;
 
-            if (!maze.InBounds(nx, ny) || maze.IsWall(nx, ny))
-                continue;
+            const OpenNode current = openSet.Pop();
+            if (current.g != g[current.idx]) return;   // 过期条目
 
-            int newCost = current.g + 1;
-            int k = key(nx, ny);
+            // ⭐ 两侧的访问按展开顺序交错记录
+            out.visited.push_back(current.p);
+            ++out.expanded;
 
-            if (!costSoFar.count(k) || newCost < costSoFar[k])
+            for (int i = 0; i < 4; ++i)
             {
-                costSoFar[k] = newCost;
-                int priority = newCost + Heuristic({ nx, ny }, maze.end);
-                openSet.push({ { nx, ny }, newCost, priority });
-                cameFrom[k] = current.p;
+                const size_t k = current.idx + off[i];
+                if (grid.cells[k] != PaddedGrid::Open) continue;
+
+                const int newCost = current.g + 1;
+                if (stamp[k] == epoch && newCost >= g[k]) continue;
+
+                stamp[k] = epoch;
+                g[k] = newCost;
+                if (forward) ctx.SetParent(k, (uint8_t)i);
+                else         ctx.SetParentBack(k, (uint8_t)i);
+
+                if (otherStamp[k] == epoch && newCost + otherG[k] < best)
+                {
+                    best = newCost + otherG[k];
+                    meet = k;
+                }
+
+                const Point np{ current.p.x + dx[i], current.p.y + dy[i] };
+                openSet.Push({ np, k, newCost, key(np, newCost, forward) });
             }
+        };
+
+        bool forwardTurn = true;
+        while (!forwardSet.Empty() && !backwardSet.Empty())
+        {
+            if (best != INT32_MAX && (int64_t)forwardSet.MinF() + backwardSet.MinF() >= 2 * (int64_t)best + 2 * D) break;
+
+            if (forwardTurn) expand(forwardSet, true);
+            else             expand(backwardSet, false);
+            forwardTurn = !forwardTurn;
+        }
+
+        if (meet == (size_t)-1) return;
+
+        // 相遇点往回接到起点，再顺着反向的来向接到终点
+        const Point meetPoint = grid.ToPoint(meet);
+        Point cur = meetPoint;
+        size_t k = meet;
+        while (k != startIdx)
+        {
+            path.push_back(cur);
+            const uint8_t d = ctx.Parent(k);
+            k -= off[d];
+            cur = { cur.x - dx[d], cur.y - dy[d] };
         }
+        path.push_back(start);
+        std::reverse(path.begin(), path.end());
+
+        cur = meetPoint;
+        k = meet;
+        while (k != endIdx)
+        {
+            const uint8_t d = ctx.ParentBack(k);
+            k -= off[d];
+            cur = { cur.x - dx[d], cur.y - dy[d] };
+            path.push_back(cur);
+        }
+    }
+
+    // 路口图上的 A*：节点 0..N-1 是图节点，N 是不在节点上的终点，N+1 是不在节点上的起点。
+    // 起点沿走廊两头各接一条边到端点节点（终点若就在这段走廊上直接接到终点）；
+    // 终点所在走廊的两端节点展开时各多一条边到 N。via 记上一个节点，parent 记从它迈出的第一步方向，
+    // 倒推时每段沿网格重走一遍展开成格子
+    template<class OpenList>
+    void GraphAStar(const JunctionGraph& graph, SearchContext& ctx, OpenList openSet, Point start, Point end, SearchResult& out)
+    {
+        auto& path = out.path;
+
+        const PaddedGrid& grid = graph.Grid();
+        const uint32_t epoch = ctx.epoch;
+        const uint32_t N = (uint32_t)graph.NodeCount();
+        const uint32_t T = N, S = N + 1;
+
+        const size_t s = grid.Index(start.x, start.y);
+        const size_t t = grid.Index(end.x, end.y);
+        const uint32_t sNode = graph.NodeOf(s);
+        const uint32_t tNode = graph.NodeOf(t);
+        const uint32_t source = (sNode != JunctionGraph::NoNode) ? sNode : S;
+        const uint32_t goal = (tNode != JunctionGraph::NoNode) ? tNode : T;
+
+        auto cellOf = [&](uint32_t v) {
+            return v == S ? s : v == T ? t : graph.NodeCell(v);
+        };
+
+        auto relax = [&](uint32_t v, uint32_t from, int dir, int32_t g) {
+            if (ctx.Seen(v) && g >= ctx.g[v]) return;
+            ctx.stamp[v] = epoch;
+            ctx.g[v] = g;
+            ctx.via[v] = from;
+            ctx.SetParent(v, (uint8_t)dir);
+
+            const Point p = grid.ToPoint(cellOf(v));
+            openSet.Push({ p, v, g, g + Heuristic(p, end) });
+        };
+
+        // 终点不在节点上：记下所在走廊两端的节点、距离和从节点走回来的方向
+        uint32_t tEnd[2] = { JunctionGraph::NoNode, JunctionGraph::NoNode };
+        int32_t tDist[2] = {};
+        int tDir[2] = {};
+        if (goal == T)
+        {
+            int n = 0;
+            for (int d = 0; d < 4 && n < 2; ++d)
+            {
+                if (grid.cells[t + grid.offsets[d]] != PaddedGrid::Open) continue;
+                int lastDir = 0;
+                const size_t c = graph.Walk(t, d, JunctionGraph::NoCell, tDist[n], lastDir);
+                tEnd[n] = graph.NodeOf(c);
+                tDir[n] = lastDir ^ 1;
+                ++n;
+            }
+        }
+
+        if (source == sNode)
+        {
+            relax(sNode, S, 0, 0);
+        }
+        else
+        {
+            ctx.stamp[S] = epoch;
+            ctx.g[S] = 0;
+            for (int d = 0; d < 4; ++d)
+            {
+                if (grid.cells[s + grid.offsets[d]] != PaddedGrid::Open) continue;
+                int32_t steps = 0;
+                int lastDir = 0;
+                const size_t c = graph.Walk(s, d, t, steps, lastDir);
+                relax(c == t ? goal : graph.NodeOf(c), S, d, steps);
+            }
+        }
+
+        while (!openSet.Empty())
+        {
+            const OpenNode current = openSet.Pop();
+            const uint32_t u = (uint32_t)current.idx;
+            if (current.g != ctx.g[u]) continue;   // 过期条目
+
+            out.visited.push_back(current.p);
+            ++out.expanded;
+
+            if (u == goal)
+            {
+                // 从终点一段段往回展开：每段先顺着写、再把这一段翻过来，最后整体翻转
+                for (uint32_t v = goal; v != source; v = ctx.via[v])
+                {
+                    const size_t mark = path.size();
+                    graph.Expand(cellOf(ctx.via[v]), ctx.Parent(v), cellOf(v), path);
+                    std::reverse(path.begin() + (ptrdiff_t)mark, path.end());
+                }
+                path.push_back(start);
+                std::reverse(path.begin(), path.end());
+                break;
+            }
+
+            for (uint32_t e = graph.EdgeBegin(u); e < graph.EdgeEnd(u); ++e)
+                relax(graph.Target(e), u, graph.Dir(e), current.g + graph.Weight(e));
+
+            for (int i = 0; i < 2; ++i)
+                if (tEnd[i] == u) relax(T, u, tDir[i], current.g + tDist[i]);
+        }
+    }
+
+    template<class OpenList>
+    void Search(SearchContext& ctx, OpenList openSet, OpenList backwardSet, Point start, Point end, SearchResult& out)
+    {
+        if (ctx.mode == SearchMode::JumpPoint)
+            JumpPoint(ctx, openSet, start, end, out);
+        else if (ctx.mode == SearchMode::Bidirectional)
+            Bidirectional(ctx, openSet, backwardSet, start, end, out);
+        else
+            AStar(ctx, openSet, start, end, out);
     }
+}
+
+void PathFinder::pathFinder(SearchContext& ctx, Point start, Point end, SearchResult& out)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    out.Clear();
+
+    const PaddedGrid& grid = ctx.grid;
+    const auto inside = [&](Point p) {
+        return p.x >= 0 && p.y >= 0 && p.x < grid.width && p.y < grid.height;
+    };
+    if (!ctx.Bound() || !inside(start) || !inside(end))
+        return;
+
+    if (ctx.mode == SearchMode::Bidirectional)
+        ctx.ReserveBack();
+
+    ctx.NextEpoch();
+    if (ctx.openList == OpenListPolicy::Buckets)
+        Search(ctx, BucketOpenList{ ctx.buckets }, BucketOpenList{ ctx.bucketsBack }, start, end, out);
+    else
+        Search(ctx, HeapOpenList{ ctx.open }, HeapOpenList{ ctx.openBack }, start, end, out);
 
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration =
         std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
-    return {
-        path,
-        visitedPoints,
-        static_cast<int32_t>(path.size()),
-        duration
+    out.length = static_cast<int32_t>(out.path.size());
+    out.elapsed = duration;
+}
+
+void PathFinder::pathFinder(const JunctionGraph& graph, SearchContext& ctx, Point start, Point end, SearchResult& out)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    out.Clear();
+
+    const PaddedGrid& grid = graph.Grid();
+    const auto open = [&](Point p) {
+        return p.x >= 0 && p.y >= 0 && p.x < grid.width && p.y < grid.height
+            && grid.cells[grid.Index(p.x, p.y)] == PaddedGrid::Open;
     };
+    if (!open(start) || !open(end))
+        return;
+
+    if (start == end)
+    {
+        out.visited.push_back(start);
+        out.path.push_back(start);
+        out.length = out.expanded = 1;
+        return;
+    }
+
+    // 图节点之外还有起点、终点两个虚节点
+    const size_t nodes = graph.NodeCount() + 2;
+    ctx.Reserve(nodes);
+    if (ctx.via.size() < nodes) ctx.via.resize(nodes);
+
+    ctx.NextEpoch();
+    if (ctx.openList == OpenListPolicy::Buckets)
+        GraphAStar(graph, ctx, BucketOpenList{ ctx.buckets }, start, end, out);
+    else
+        GraphAStar(graph, ctx, HeapOpenList{ ctx.open }, start, end, out);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration =
+        std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+    out.length = static_cast<int32_t>(out.path.size());
+    out.elapsed = duration;
 }
 
-std::tuple<std::vector<Point>,std::vector<Point> , int32_t, std::chrono::milliseconds>
-WallBreaker::BreakWalls(Maze maze, int32_t breakCount)
+SearchResult PathFinder::pathFinder(const PassageGrid& passages, Point start, Point end)
+{
+    SearchResult out;
+    pathFinder(passages, start, end, out);
+    return out;
+}
+
+void PathFinder::pathFinder(const PassageGrid& passages, Point start, Point end, SearchResult& out)
 {
-    //破墙路径 使用空间BFS算法
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    struct State {
-        Point p;
-        int broken;
+    out.Clear();
+    auto& visitedPoints = out.visited;
+    auto& path = out.path;
+
+    // 起终点必须是房间格（奇数坐标）
+    auto toRoom = [&](Point p, size_t& room) {
+        if (p.x < 1 || p.y < 1 || !(p.x & 1) || !(p.y & 1)) return false;
+        const int32_t rx = (p.x - 1) / 2;
+        const int32_t ry = (p.y - 1) / 2;
+        if (rx >= passages.roomsW || ry >= passages.roomsH) return false;
+        room = passages.Room(rx, ry);
+        return true;
     };
 
-    std::queue<State> q;
+    size_t s = 0, t = 0;
+    if (!toRoom(start, s) || !toRoom(end, t))
+        return;
+
+    const size_t W = (size_t)passages.roomsW;
+    const std::array<ptrdiff_t, 4> off = { 1, -1, (ptrdiff_t)W, -(ptrdiff_t)W };
 
-    auto key = [&](int x, int y, int b) {
-        return b * maze.width * maze.height + y * maze.width + x;
+    auto roomCell = [&](size_t r) -> Point {
+        return { (int32_t)(r % W) * 2 + 1, (int32_t)(r / W) * 2 + 1 };
     };
 
-    std::unordered_set<int> visited;
-    std::vector<Point> visitedPoints;
-    std::unordered_map<int, State> parent;
+    // 到达方向：0..3 = 从哪个方向走进来，4 = 起点，0xFF = 未访问
+    constexpr uint8_t UNSEEN = 0xFF;
+    std::vector<uint8_t> cameDir(passages.RoomCount(), UNSEEN);
+    std::vector<size_t> queue;
+    queue.reserve(passages.RoomCount());
+
+    queue.push_back(s);
+    cameDir[s] = 4;
+
+    bool found = false;
+    for (size_t head = 0; head < queue.size(); ++head)
+    {
+        const size_t cur = queue[head];
+        visitedPoints.push_back(roomCell(cur));
+
+        if (cur == t) { found = true; break; }
+
+        uint8_t m = passages.Mask(cur);
+        while (m)
+        {
+            const int d = std::countr_zero(m);
+            m &= (uint8_t)(m - 1);
+
+            const size_t n = (size_t)((ptrdiff_t)cur + off[d]);
+            if (cameDir[n] != UNSEEN) continue;
 
-    q.push({ maze.start, 0 });
-    visited.insert(key(maze.start.x, maze.start.y, 0));
+            cameDir[n] = (uint8_t)d;
+            queue.push_back(n);
+        }
+    }
 
-    int endKey = -1;
+    if (found)
+    {
+        size_t cur = t;
+        path.push_back(roomCell(cur));
+        while (cameDir[cur] != 4)
+        {
+            const size_t prev = (size_t)((ptrdiff_t)cur - off[cameDir[cur]]);
+            const Point a = roomCell(cur);
+            const Point b = roomCell(prev);
+            path.push_back({ (a.x + b.x) / 2, (a.y + b.y) / 2 });
+            path.push_back(b);
+            cur = prev;
+        }
+        std::reverse(path.begin(), path.end());
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration =
+        std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+    out.length = static_cast<int32_t>(path.size());
+    out.expanded = static_cast<int32_t>(visitedPoints.size());
+    out.elapsed = duration;
+}
+
+SearchResult WallBreaker::BreakWalls(MazeView maze, int32_t breakCount)
+{
+    SearchResult out;
+    BreakWalls(maze, breakCount, out);
+    return out;
+}
+
+void WallBreaker::BreakWalls(MazeView maze, int32_t breakCount, SearchResult& out)
+{
+    SearchContext ctx;
+    ctx.Bind(maze);
+    BreakWalls(ctx, maze.start, maze.end, breakCount, out);
+}
+
+void WallBreaker::BreakWalls(SearchContext& ctx, Point start, Point end, int32_t breakCount, SearchResult& out)
+{
+    //破墙路径 使用空间BFS算法
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    out.Clear();
+    auto& visitedPoints = out.visited;
+    auto& path = out.path;
+
+    // 外圈哨兵为 Ring（不可破），内部墙为 Wall
+    const PaddedGrid& grid = ctx.grid;
+    const auto& off = grid.offsets;
+    const size_t cellCount = grid.Size();
+    breakCount = std::max(breakCount, 0);
+
+    ctx.NextEpoch();
+    ctx.NextLayerEpoch((size_t)breakCount + 1);
+
+    // 队列借用 ctx.open，按下标顺序出队；g 存已破墙数
+    auto& queue = ctx.open;
+    auto key = [&](size_t idx, int32_t b) {
+        return (size_t)b * cellCount + idx;
+    };
+
+    const size_t startIdx = grid.Index(start.x, start.y);
+    queue.push_back({ start, startIdx, 0, 0 });
+    ctx.MarkLayer(key(startIdx, 0), 0);
+
+    size_t endKey = (size_t)-1;
 
     const int dx[4] = { 1, -1, 0, 0 };
     const int dy[4] = { 0, 0, 1, -1 };
 
-    while (!q.empty())
+    for (size_t head = 0; head < queue.size(); ++head)
     {
-        State cur = q.front(); q.pop();
+        const OpenNode cur = queue[head];
 
         // ⭐ 记录访问节点（去重）
         visitedPoints.push_back(cur.p);
 
-        if (cur.p == maze.end)
+        if (cur.p == end)
         {
-            endKey = key(cur.p.x, cur.p.y, cur.broken);
+            endKey = key(cur.idx, cur.g);
             break;
         }
 
         for (int i = 0; i < 4; ++i)
         {
-            int nx = cur.p.x + dx[i];
-            int ny = cur.p.y + dy[i];
+            const size_t n = cur.idx + off[i];
+            const uint8_t c = grid.cells[n];
+            if (c == PaddedGrid::Ring) continue;
 
-            if (!maze.InBounds(nx, ny)) continue;
-
-            int nb = cur.broken + (maze.IsWall(nx, ny) ? 1 : 0);
+            const int32_t nb = cur.g + c;
             if (nb > breakCount) continue;
 
-            int nk = key(nx, ny, nb);
-            if (visited.count(nk)) continue;
+            const size_t nk = key(n, nb);
+            if (ctx.SeenLayer(nk)) continue;
 
-            visited.insert(nk);
-            parent[nk] = cur;
-            q.push({ { nx, ny }, nb });
+            ctx.MarkLayer(nk, (uint8_t)i);
+            queue.push_back({ { cur.p.x + dx[i], cur.p.y + dy[i] }, n, nb, 0 });
         }
     }
 
-    std::vector<Point> path;
-
-    if (endKey != -1)
+    if (endKey != (size_t)-1)
     {
-        int curKey = endKey;
-        State curState = {
-            maze.end,
-            curKey / (maze.width * maze.height)
-        };
+        // 倒推：上一格 = 本格减去来向偏移；走进墙格的那一步破了一面墙，层数减一
+        size_t idx = endKey % cellCount;
+        int32_t b = (int32_t)(endKey / cellCount);
 
-        while (!(curState.p == maze.start && curState.broken == 0))
+        while (!(idx == startIdx && b == 0))
         {
-            path.push_back(curState.p);
-            curState = parent[curKey];
-            curKey = key(curState.p.x, curState.p.y, curState.broken);
+            path.push_back(grid.ToPoint(idx));
+            const uint8_t dir = ctx.LayerParent(key(idx, b));
+            b -= grid.cells[idx];
+            idx -= off[dir];
         }
 
-        path.push_back(maze.start);
+        path.push_back(start);
         std::reverse(path.begin(), path.end());
     }
 
@@ -178,42 +717,55 @@ WallBreaker::BreakWalls(Maze maze, int32_t breakCount)
     auto duration =
         std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
-    return {
-        path,
-        visitedPoints,
-        static_cast<int32_t>(path.size()),
-        duration
-    };
+    out.length = static_cast<int32_t>(path.size());
+    out.expanded = static_cast<int32_t>(visitedPoints.size());
+    out.elapsed = duration;
 }
 
-//return pair<paths,lengths> , ways , time
-std::tuple<std::pair<std::vector<std::vector<Point>>, std::vector<int32_t>>, int32_t, std::chrono::milliseconds>
-PathCounter::CountPaths(Maze maze, Point start, Point end)
+CountResult PathCounter::CountPaths(MazeView maze, Point start, Point end)
+{
+    CountResult out;
+    CountPaths(maze, start, end, out);
+    return out;
+}
+
+void PathCounter::CountPaths(MazeView maze, Point start, Point end, CountResult& out)
+{
+    SearchContext ctx;
+    ctx.Bind(maze);
+    CountPaths(ctx, start, end, out);
+}
+
+// out: paths, lengths, ways, time
+void PathCounter::CountPaths(SearchContext& ctx, Point start, Point end, CountResult& out)
 {
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    std::vector<std::vector<Point>> allPaths;
-    std::vector<int32_t> lengths;
+    out.Clear();
+    auto& allPaths = out.paths;
+    auto& lengths = out.lengths;
     std::vector<Point> current;
 
     if (start == end)
     {
         allPaths.push_back({ start });
         lengths.push_back(1);
-        return { { allPaths, lengths }, 1, std::chrono::milliseconds(0) };
+        out.ways = 1;
+        return;
     }
 
     const int dx[4] = { 1, -1, 0, 0 };
     const int dy[4] = { 0, 0, 1, -1 };
 
-    // 点访问标记：防止节点重复（简单路径）
-    std::vector<std::vector<bool>> visited(
-        maze.height, std::vector<bool>(maze.width, false));
+    // 哨兵网格兼作 blocked 表：墙、外圈、已在当前路径上的点都不可走；路径上的格子回溯时恢复原值
+    auto& blocked = ctx.grid.cells;
+    const auto& off = ctx.grid.offsets;
 
-    std::function<void(Point)> dfs = [&](Point p)
+    std::function<void(Point, size_t)> dfs = [&](Point p, size_t idx)
     {
         current.push_back(p);
-        visited[p.y][p.x] = true;
+        const uint8_t saved = blocked[idx];
+        blocked[idx] = PaddedGrid::Wall;
 
         if (p == end)
         {
@@ -224,205 +776,174 @@ PathCounter::CountPaths(Maze maze, Point start, Point end)
         {
             for (int i = 0; i < 4; ++i)
             {
-                int nx = p.x + dx[i];
-                int ny = p.y + dy[i];
+                const size_t n = idx + off[i];
+                if (blocked[n]) continue;
 
-                if (!maze.InBounds(nx, ny)) continue;
-                if (maze.IsWall(nx, ny)) continue;
-                if (visited[ny][nx]) continue;
-
-                dfs({ nx, ny });
+                dfs({ p.x + dx[i], p.y + dy[i] }, n);
             }
         }
 
-        visited[p.y][p.x] = false;
+        blocked[idx] = saved;
         current.pop_back();
     };
 
-    dfs(start);
+    dfs(start, ctx.grid.Index(start.x, start.y));
 
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration =
         std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
-    return {
-        { allPaths, lengths },
-        static_cast<int32_t>(allPaths.size()),
-        duration
-    };
+    out.ways = static_cast<int32_t>(allPaths.size());
+    out.elapsed = duration;
 }
 
-std::tuple<std::vector<Point>, std::vector<Point>,std::vector<Point>, int32_t, std::chrono::milliseconds>
-PathPasser::PassPath(Maze maze, uint32_t x, uint32_t y)
+PassResult PathPasser::PassPath(MazeView maze, uint32_t x, uint32_t y)
+{
+    PassResult out;
+    PassPath(maze, x, y, out);
+    return out;
+}
+
+void PathPasser::PassPath(MazeView maze, uint32_t x, uint32_t y, PassResult& out)
+{
+    const Point mid{ static_cast<int>(x), static_cast<int>(y) };
+    if (!maze.InBounds(mid.x, mid.y) || maze.IsWall(mid.x, mid.y))
+    {
+        out.Clear();
+        return;
+    }
+
+    SearchContext ctx;
+    ctx.Bind(maze);
+    PassPath(ctx, maze.start, maze.end, mid, out);
+}
+
+void PathPasser::PassPath(SearchContext& ctx, Point start, Point end, Point mid, PassResult& out)
 {
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    Point mid{ static_cast<int>(x), static_cast<int>(y) };
+    out.Clear();
 
-    std::vector<Point> empty;
-    if (!maze.InBounds(mid.x, mid.y) || maze.IsWall(mid.x, mid.y))
+    const PaddedGrid& grid = ctx.grid;
+    if (mid.x < 0 || mid.y < 0 || mid.x >= grid.width || mid.y >= grid.height
+        || grid.cells[grid.Index(mid.x, mid.y)] != PaddedGrid::Open)
     {
-        return { empty, empty, empty, 0, std::chrono::milliseconds(0) };
+        return;
     }
 
     const int dx[4] = { 1, -1, 0, 0 };
     const int dy[4] = { 0, 0, 1, -1 };
+    const auto& off = grid.offsets;
+    ctx.ReserveBack();
 
-    auto key = [&](int x, int y) {
-        return y * maze.width + x;
-    };
-
-    auto biBFS = [&](Point start, Point end,
-                     std::vector<Point>& visitedOut) -> std::vector<Point>
+    // 一段双向 BFS：正向一侧记在 stamp / parent、队列借 open，反向一侧记在 stampBack / parentBack、队列借 openBack；
+    // 两侧按层交替，新格子已被另一侧访问过就是相遇点。路径直接追加到 out.path
+    auto biBFS = [&](Point from, Point to, std::vector<Point>& visitedOut) -> bool
     {
-        // +++ add: trivial case
-        if (start == end)
+        if (from == to)
         {
-            visitedOut.push_back(start);
-            return { start };
+            visitedOut.push_back(from);
+            out.path.push_back(from);
+            return true;
         }
-        // --- add
 
-        std::queue<Point> q1, q2;
-        std::unordered_map<int, Point> prev1, prev2;
-        std::unordered_set<int> vis1, vis2;
+        ctx.NextEpoch();
+        const uint32_t epoch = ctx.epoch;
+        const size_t fromIdx = grid.Index(from.x, from.y);
+        const size_t toIdx = grid.Index(to.x, to.y);
 
-        q1.push(start);
-        q2.push(end);
-        vis1.insert(key(start.x, start.y));
-        vis2.insert(key(end.x, end.y));
+        ctx.open.push_back({ from, fromIdx, 0, 0 });
+        ctx.openBack.push_back({ to, toIdx, 0, 0 });
+        ctx.stamp[fromIdx] = epoch;
+        ctx.stampBack[toIdx] = epoch;
 
-        Point meet{ -1, -1 };
+        size_t head1 = 0, head2 = 0;
+        size_t meet = (size_t)-1;
 
-        while (!q1.empty() && !q2.empty())
+        // 扩展一侧的一整层；找到相遇点返回 true
+        auto expandLayer = [&](bool back) -> bool
         {
-            int s1 = (int)q1.size();
-            while (s1--)
-            {
-                Point cur = q1.front(); q1.pop();
-                visitedOut.push_back(cur);
-
-                for (int i = 0; i < 4; ++i)
-                {
-                    int nx = cur.x + dx[i];
-                    int ny = cur.y + dy[i];
-                    int k = key(nx, ny);
-
-                    if (!maze.InBounds(nx, ny) || maze.IsWall(nx, ny)) continue;
-                    if (vis1.count(k)) continue;
-
-                    vis1.insert(k);
-                    prev1[k] = cur;
+            auto& q = back ? ctx.openBack : ctx.open;
+            size_t& head = back ? head2 : head1;
+            auto& mine = back ? ctx.stampBack : ctx.stamp;
+            const auto& other = back ? ctx.stamp : ctx.stampBack;
 
-                    if (vis2.count(k))
-                    {
-                        meet = { nx, ny };
-                        goto BUILD_PATH;
-                    }
-                    q1.push({ nx, ny });
-                }
-            }
-
-            int s2 = (int)q2.size();
-            while (s2--)
+            for (size_t n = q.size() - head; n > 0; --n)
             {
-                Point cur = q2.front(); q2.pop();
-                visitedOut.push_back(cur);
+                const OpenNode cur = q[head++];
+                visitedOut.push_back(cur.p);
 
                 for (int i = 0; i < 4; ++i)
                 {
-                    int nx = cur.x + dx[i];
-                    int ny = cur.y + dy[i];
-                    int k = key(nx, ny);
-
-                    if (!maze.InBounds(nx, ny) || maze.IsWall(nx, ny)) continue;
-                    if (vis2.count(k)) continue;
+                    const size_t k = cur.idx + off[i];
+                    if (grid.cells[k] != PaddedGrid::Open) continue;
+                    if (mine[k] == epoch) continue;
 
-                    vis2.insert(k);
-                    prev2[k] = cur;
+                    mine[k] = epoch;
+                    if (back) ctx.SetParentBack(k, (uint8_t)i);
+                    else ctx.SetParent(k, (uint8_t)i);
 
-                    if (vis1.count(k))
+                    if (other[k] == epoch)
                     {
-                        meet = { nx, ny };
-                        goto BUILD_PATH;
+                        meet = k;
+                        return true;
                     }
-                    q2.push({ nx, ny });
+                    q.push_back({ { cur.p.x + dx[i], cur.p.y + dy[i] }, k, 0, 0 });
                 }
             }
-        }
-
-    BUILD_PATH:
-        if (meet.x == -1) return empty;
-
-        std::vector<Point> path1, path2;
+            return false;
+        };
 
-        Point cur = meet;
-        while (!(cur == start))
+        while (head1 < ctx.open.size() && head2 < ctx.openBack.size())
         {
-            path1.push_back(cur);
-            cur = prev1[key(cur.x, cur.y)];
+            if (expandLayer(false) || expandLayer(true)) break;
         }
-        path1.push_back(start);
-        std::reverse(path1.begin(), path1.end());
 
-        cur = meet;
-        while (!(cur == end))
+        if (meet == (size_t)-1) return false;
+
+        // 相遇点倒推回起点（反转这一段），再沿反向来向走到终点
+        const size_t mark = out.path.size();
+        for (size_t cur = meet; cur != fromIdx; cur -= off[ctx.Parent(cur)])
+            out.path.push_back(grid.ToPoint(cur));
+        out.path.push_back(from);
+        std::reverse(out.path.begin() + (ptrdiff_t)mark, out.path.end());
+
+        for (size_t cur = meet; cur != toIdx; )
         {
-            cur = prev2[key(cur.x, cur.y)];
-            path2.push_back(cur);
+            cur -= off[ctx.ParentBack(cur)];
+            out.path.push_back(grid.ToPoint(cur));
         }
-
-        path1.insert(path1.end(), path2.begin(), path2.end());
-        return path1;
+        return true;
     };
 
     // +++ add: if mid is start/end, it should degenerate to normal shortest path
-    if (mid == maze.start)
+    if (mid == start || mid == end)
     {
-        std::vector<Point> visitedSE;
-        auto pathSE = biBFS(maze.start, maze.end, visitedSE);
+        biBFS(start, end, out.visitedToMid);
 
         auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-        return { pathSE, visitedSE, empty, (int32_t)pathSE.size(), duration };
-    }
-    if (mid == maze.end)
-    {
-        std::vector<Point> visitedSE;
-        auto pathSE = biBFS(maze.start, maze.end, visitedSE);
-
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-
-        return { pathSE, visitedSE, empty, (int32_t)pathSE.size(), duration };
+        out.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+        out.length = (int32_t)out.path.size();
+        return;
     }
     // --- add
 
     // ================= 执行两段 =================
-    std::vector<Point> visitedSP, visitedPE;
-    auto path1 = biBFS(maze.start, mid, visitedSP);
-    auto path2 = biBFS(mid, maze.end, visitedPE);
+    // 两段都跑（访问记录与原来一致），第一段的终点即第二段的起点，只留一份
+    const bool first = biBFS(start, mid, out.visitedToMid);
+    if (first) out.path.pop_back();
+    const bool second = biBFS(mid, end, out.visitedFromMid);
 
-    if (path1.empty() || path2.empty())
+    if (!first || !second)
     {
-        return { empty, visitedSP, visitedPE, 0,
-                 std::chrono::milliseconds(0) };
+        out.path.clear();
+        return;
     }
 
-    path1.pop_back();
-    path1.insert(path1.end(), path2.begin(), path2.end());
-
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration =
         std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
-    return {
-        path1,
-        visitedSP,
-        visitedPE,
-        static_cast<int32_t>(path1.size()),
-        duration
-    };
+    out.length = static_cast<int32_t>(out.path.size());
+    out.elapsed = duration;
 }
-
@@ -0,0 +1,256 @@
+#include "core/WordRows.hpp"
+#include "core/DataStruct.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define MAZE_WORDROWS_X86 1
+#endif
+
+namespace
+{
+    // 低 32 位隔位展开：bit i -> bit 2i
+    uint64_t Spread(uint64_t x)
+    {
+        x &= 0xFFFFFFFFull;
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+        x = (x | (x << 8))  & 0x00FF00FF00FF00FFull;
+        x = (x | (x << 4))  & 0x0F0F0F0F0F0F0F0Full;
+        x = (x | (x << 2))  & 0x3333333333333333ull;
+        x = (x | (x << 1))  & 0x5555555555555555ull;
+        return x;
+    }
+
+    // 第 k 组 32 个房间
+    uint64_t Chunk(std::span<const uint64_t> v, size_t k)
+    {
+        return v[k / 2] >> ((k % 2) * 32);
+    }
+
+    // 一路 xoshiro256**，与 Xoshiro256::Next64 相同
+    uint64_t StepLane(std::array<uint64_t, 16>& s, size_t l)
+    {
+        uint64_t& s0 = s[l];
+        uint64_t& s1 = s[4 + l];
+        uint64_t& s2 = s[8 + l];
+        uint64_t& s3 = s[12 + l];
+
+        const uint64_t result = std::rotl(s1 * 5, 7) * 9;
+        const uint64_t t = s1 << 17;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = std::rotl(s3, 45);
+        return result;
+    }
+
+#ifdef MAZE_WORDROWS_X86
+    // 4 路一起推进：乘 5 / 乘 9 拆成移位加，循环移位拆成两次移位
+    __attribute__((target("avx2")))
+    void FillAvx2(std::array<uint64_t, 16>& s, uint64_t* out, size_t blocks)
+    {
+        __m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[0]));
+        __m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[4]));
+        __m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[8]));
+        __m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[12]));
+
+        for (size_t b = 0; b < blocks; ++b)
+        {
+            const __m256i m5 = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+            const __m256i r7 = _mm256_or_si256(_mm256_slli_epi64(m5, 7), _mm256_srli_epi64(m5, 57));
+            const __m256i result = _mm256_add_epi64(_mm256_slli_epi64(r7, 3), r7);
+            const __m256i t = _mm256_slli_epi64(s1, 17);
+
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + b * 4), result);
+        }
+
+        _mm256_store_si256(reinterpret_cast<__m256i*>(&s[0]), s0);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(&s[4]), s1);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(&s[8]), s2);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(&s[12]), s3);
+    }
+
+    __attribute__((target("avx2")))
+    __m256i Spread4(__m256i x)
+    {
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi64(x, 16)), _mm256_set1_epi64x(0x0000FFFF0000FFFFll));
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi64(x, 8)),  _mm256_set1_epi64x(0x00FF00FF00FF00FFll));
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi64(x, 4)),  _mm256_set1_epi64x(0x0F0F0F0F0F0F0F0Fll));
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi64(x, 2)),  _mm256_set1_epi64x(0x3333333333333333ll));
+        x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi64(x, 1)),  _mm256_set1_epi64x(0x5555555555555555ll));
+        return x;
+    }
+
+    // 一次展开 4 个网格字（128 个房间）；返回处理到的字数，余下的交给标量
+    __attribute__((target("avx2")))
+    size_t ExpandAvx2(const uint64_t* valid, const uint64_t* west, const uint64_t* north,
+                      uint64_t* gapRow, uint64_t* roomRow, size_t words)
+    {
+        const __m256i ones = _mm256_set1_epi64x(-1);
+        size_t k = 0;
+        for (; k + 4 <= words; k += 4)
+        {
+            // 两个房间字 = 4 组 32 房间，零扩展到 4 个 64 位通道
+            const __m256i v = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(valid + k / 2)));
+            const __m256i w = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(west + k / 2)));
+            const __m256i n = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(north + k / 2)));
+
+            const __m256i open = _mm256_or_si256(_mm256_slli_epi64(Spread4(v), 1), Spread4(w));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(roomRow + k), _mm256_xor_si256(open, ones));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(gapRow + k), _mm256_xor_si256(_mm256_slli_epi64(Spread4(n), 1), ones));
+        }
+        return k;
+    }
+#endif
+}
+
+bool WordRows::HasAvx2()
+{
+#ifdef MAZE_WORDROWS_X86
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+#else
+    return false;
+#endif
+}
+
+WordRows::WordRows(Kind kind, int32_t roomsW, Xoshiro256& rng, bool avx2)
+    : kind(kind), roomsW(roomsW), avx2(avx2 && HasAvx2()),
+      rowWords(((size_t)roomsW * 2 + 1 + WallBitmap::WordBits - 1) / WallBitmap::WordBits)
+{
+    uint64_t seed = rng.Next64();
+    for (auto& w : lanes) w = SplitMix64(seed);
+    pick = Xoshiro256(rng.Next64());
+
+    // 房间字补到能按 4 个网格字一组整读，随机字补到 4 的倍数
+    const size_t roomWords = RoomWords(roomsW);
+    coins.assign((roomWords + 3) / 4 * 4, 0);
+    valid.assign(roomWords, 0);
+    north.assign(roomWords, 0);
+    east.assign(roomWords, 0);
+    west.assign(roomWords, 0);
+
+    for (int32_t rx = 0; rx < roomsW; rx += 64)
+    {
+        const int32_t n = std::min(roomsW - rx, 64);
+        valid[(size_t)rx / 64] = (n == 64) ? ~0ull : ((1ull << n) - 1);
+    }
+}
+
+void WordRows::FillCoins()
+{
+    const size_t blocks = coins.size() / 4;
+#ifdef MAZE_WORDROWS_X86
+    if (avx2)
+    {
+        FillAvx2(lanes, coins.data(), blocks);
+        return;
+    }
+#endif
+    for (size_t b = 0; b < blocks; ++b)
+        for (size_t l = 0; l < 4; ++l)
+            coins[b * 4 + l] = StepLane(lanes, l);
+}
+
+void WordRows::Next()
+{
+    const size_t n = ((size_t)roomsW + 63) / 64;
+    const size_t lastWord = (size_t)(roomsW - 1) / 64;
+    const uint64_t lastBit = 1ull << ((roomsW - 1) % 64);
+
+    if (ry == 0)
+    {
+        // 首行：两种算法都整行向东打通
+        for (size_t j = 0; j < n; ++j)
+        {
+            north[j] = 0;
+            east[j] = valid[j];
+        }
+        east[lastWord] &= ~lastBit;
+    }
+    else if (kind == Kind::BinaryTree)
+    {
+        // 硬币为 1 向北，否则向西；最西一列只能向北
+        FillCoins();
+        for (size_t j = 0; j < n; ++j)
+            north[j] = coins[j] & valid[j];
+        north[0] |= 1;
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            const uint64_t goWest = valid[j] & ~north[j];
+            east[j] = goWest >> 1;
+            if (j > 0) east[j - 1] |= goWest << 63;
+        }
+    }
+    else
+    {
+        // 硬币为 1 结束当前段（行末必结束），未结束的房间向东；每段等概率选一个房间向北
+        FillCoins();
+        for (size_t j = 0; j < n; ++j)
+        {
+            coins[j] &= valid[j];
+            north[j] = 0;
+        }
+        coins[lastWord] |= lastBit;
+
+        for (size_t j = 0; j < n; ++j)
+            east[j] = valid[j] & ~coins[j];
+
+        uint64_t runStart = 0;
+        for (size_t j = 0; j < n; ++j)
+        {
+            for (uint64_t c = coins[j]; c != 0; c &= c - 1)
+            {
+                const uint64_t end = j * 64 + (uint64_t)std::countr_zero(c);
+                const uint64_t k = (end == runStart) ? end : runStart + UniformBelow(pick, end - runStart + 1);
+                north[k / 64] |= 1ull << (k % 64);
+                runStart = end + 1;
+            }
+        }
+    }
+
+    // 房间向西 = 左邻向东
+    for (size_t j = 0; j < n; ++j)
+        west[j] = (east[j] << 1) | ((j > 0) ? (east[j - 1] >> 63) : 0);
+
+    ++ry;
+}
+
+size_t WordRows::RoomWords(int32_t roomsW)
+{
+    const size_t rowWords = ((size_t)roomsW * 2 + 1 + WallBitmap::WordBits - 1) / WallBitmap::WordBits;
+    return (rowWords + 3) / 4 * 2;
+}
+
+void WordRows::Expand(std::span<uint64_t> gapRow, std::span<uint64_t> roomRow) const
+{
+    ExpandRow(valid, west, north, gapRow.first(rowWords), roomRow.first(rowWords), avx2);
+}
+
+void WordRows::ExpandRow(std::span<const uint64_t> valid, std::span<const uint64_t> west, std::span<const uint64_t> gaps,
+                         std::span<uint64_t> gapRow, std::span<uint64_t> roomRow, bool avx2)
+{
+    const size_t rowWords = roomRow.size();
+    size_t k = 0;
+#ifdef MAZE_WORDROWS_X86
+    if (avx2 && HasAvx2())
+        k = ExpandAvx2(valid.data(), west.data(), gaps.data(), gapRow.data(), roomRow.data(), rowWords);
+#else
+    (void)avx2;
+#endif
+    // 网格字 k 覆盖房间 32k .. 32k+31：bit 2i 为房间 32k+i 的西墙缝，bit 2i+1 为房间本身 / 墙缝
+    for (; k < rowWords; ++k)
+    {
+        roomRow[k] = ~((Spread(Chunk(valid, k)) << 1) | Spread(Chunk(west, k)));
+        gapRow[k] = ~(Spread(Chunk(gaps, k)) << 1);
+    }
+}
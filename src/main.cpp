@@ -1,9 +1,83 @@
 #include "core/Common.hpp"
+#include "core/MazeBuilder.hpp"
+#include "core/MazeFile.hpp"
 
-void runApp();
+void runApp(const std::string& mazePath);
+void runBench();
 
-int main()
+int main(int argc, char** argv)
 {
-    runApp();
+    const std::string mode = (argc > 1) ? argv[1] : "";
+
+    // MazeGame --bench：只跑命令行基准，不开窗口
+    if (mode == "--bench")
+    {
+        runBench();
+        return 0;
+    }
+
+    // MazeGame --save <file> [seed] [width height]：生成迷宫并写入文件
+    if (mode == "--save" && argc > 2)
+    {
+        const int seed = (argc > 3) ? std::stoi(argv[3]) : 0;
+        const int32_t w = (argc > 4) ? std::stoi(argv[4]) : MazeBuilder::DefaultSize;
+        const int32_t h = (argc > 5) ? std::stoi(argv[5]) : w;
+        Maze maze = MazeBuilder::Build(seed, w, h);
+        maze.start = { 1, 1 };
+        maze.end   = { std::max(1, maze.width - 2), std::max(1, maze.height - 2) };
+        MazeFile::Save(maze, argv[2]);
+        return 0;
+    }
+
+    // MazeGame --stream <file> [seed] [width height]：Eller 逐行生成直接写盘，内存只占一行
+    if (mode == "--stream" && argc > 2)
+    {
+        const int seed = (argc > 3) ? std::stoi(argv[3]) : 0;
+        const int32_t w = MazeBuilder::NormalizeSide((argc > 4) ? std::stoi(argv[4]) : MazeBuilder::DefaultSize);
+        const int32_t h = std::max((argc > 5) ? std::stoi(argv[5]) : w, MazeBuilder::MinSide) | 1;
+
+        MazeFileWriter writer(argv[2], w, h, seed, MazeGenerator::Eller, { 1, 1 }, { w - 2, h - 2 });
+        MazeBuilder::BuildStream(seed, w, h, [&](int32_t, std::span<const uint64_t> row) {
+            writer.WriteRow(row);
+        });
+        writer.Finish();
+        return 0;
+    }
+
+    // MazeGame --batch <file> <count> [firstSeed] [width height] [threads]：并行生成 count 个种子连续的迷宫，写成一个语料文件
+    if (mode == "--batch" && argc > 3)
+    {
+        const int count = std::max(0, std::stoi(argv[3]));
+        const int first = (argc > 4) ? std::stoi(argv[4]) : 0;
+        const int32_t w = MazeBuilder::NormalizeSide((argc > 5) ? std::stoi(argv[5]) : MazeBuilder::DefaultSize);
+        const int32_t h = MazeBuilder::NormalizeSide((argc > 6) ? std::stoi(argv[6]) : w);
+        const int32_t threads = (argc > 7) ? std::stoi(argv[7]) : 0;
+
+        std::vector<int> seeds((size_t)count);
+        for (int i = 0; i < count; ++i) seeds[(size_t)i] = first + i;
+
+        const BuildOptions options;
+        MazeCorpusWriter writer(argv[2], w, h, options.generator, options.layout, { 1, 1 }, { w - 2, h - 2 });
+
+        const auto t0 = std::chrono::steady_clock::now();
+        MazeBuilder::BuildBatch(seeds, w, h, options, threads, [&](size_t, const Maze& maze) {
+            writer.Add(maze);
+        });
+        writer.Finish();
+        const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        std::cout << count << " mazes " << w << "x" << h << " in " << s * 1000.0 << " ms ("
+                  << (s > 0 ? count / s : 0.0) << " mazes/s)\n";
+        return 0;
+    }
+
+    // MazeGame --open <file>：直接映射已保存的迷宫，不重新生成
+    if (mode == "--open" && argc > 2)
+    {
+        runApp(argv[2]);
+        return 0;
+    }
+
+    runApp({});
     return 0;
-}
\ No newline at end of file
+}